@@ -92,6 +92,163 @@ def printpropmap(fp, propmap, class_idx):
         print >>fp, '#endif /* SIZEOF_LINEFOLD_CHAR > 1 */'
     return num4, num2, num1
 
+# Bit widths of block indices of property trie.
+TRIE_SHIFT1 = 11
+TRIE_SHIFT2 = 5
+TRIE_MAX = 0x10FFFF
+
+def printarray(fp, ctype, name, values, fmt='%3d', perline=16):
+    print >>fp, 'static const %s %s[] = {' % (ctype, name)
+    for i in range(0, len(values), perline):
+        print >>fp, '    ' + \
+              ', '.join([fmt % v for v in values[i:i+perline]]) + ','
+    print >>fp, '};'
+    print >>fp, ''
+
+def printproptrie(fp, propmaps, class_idx, unknown):
+    """Write three-stage tables of character properties.
+
+    propmaps is list of (suffix, propmap).  Maps share tables of
+    values, blocks and middle indices; each map has its own top index.
+    Characters not in the map have the property unknown.
+    """
+    nmid = 1 << (TRIE_SHIFT1 - TRIE_SHIFT2)
+    nblock = 1 << TRIE_SHIFT2
+
+    values = [unknown]
+    value_idx = {unknown: 0}
+    blocks = []
+    block_idx = {}
+    mids = []
+    mid_idx = {}
+    index1s = []
+    for suffix, propmap in propmaps:
+        index1 = []
+        for hi in range((TRIE_MAX >> TRIE_SHIFT1) + 1):
+            mid = []
+            for b in range(nmid):
+                base = (hi << TRIE_SHIFT1) + (b << TRIE_SHIFT2)
+                block = []
+                for u in range(base, base + nblock):
+                    v = propmap.get(u, unknown)
+                    if not value_idx.has_key(v):
+                        value_idx[v] = len(values)
+                        values.append(v)
+                    block.append(value_idx[v])
+                block = tuple(block)
+                if not block_idx.has_key(block):
+                    block_idx[block] = len(blocks)
+                    blocks.append(block)
+                mid.append(block_idx[block])
+            mid = tuple(mid)
+            if not mid_idx.has_key(mid):
+                mid_idx[mid] = len(mids)
+                mids.append(mid)
+            index1.append(mid_idx[mid])
+        index1s.append((suffix, index1))
+
+    if len(values) > 0x100:
+        raise ValueError, 'Too many kinds of properties: %d' % len(values)
+    if len(blocks) > 0x10000:
+        raise ValueError, 'Too many blocks: %d' % len(blocks)
+    if len(mids) > 0x100:
+        index1type = 'unsigned short'
+    else:
+        index1type = 'unsigned char'
+
+    print >>fp, """\
+/*
+ * Character properties related on line breaking behavior.
+ */
+typedef struct
+{
+	linefold_width  width;        /* UAX#11 East Asian Width */
+	linefold_class  lbclass;      /* UAX#14 Line Breaking Class */
+} lbprop_value;
+
+/*
+ * Unicode Character Property Trie
+ *
+ * Property of character c (0 <= c <= 0x%(max)X) is
+ *   lbprop_values[lbprop_blocks[(lbprop_index2[(index1[c >> %(s1)d] << %(s12)d) +
+ *                                              ((c >> %(s2)d) & 0x%(m12)X)] << %(s2)d) +
+ *                               (c & 0x%(m2)X)]].
+ */
+#define LBPROP_SHIFT1 %(s1)d
+#define LBPROP_SHIFT2 %(s2)d
+#define LBPROP_MAX 0x%(max)X
+
+static const lbprop_value lbprop_values[] = {""" % \
+        {'max': TRIE_MAX, 's1': TRIE_SHIFT1, 's2': TRIE_SHIFT2,
+         's12': TRIE_SHIFT1 - TRIE_SHIFT2,
+         'm12': nmid - 1, 'm2': nblock - 1, }
+    for width, lbc in values:
+        print >>fp, '    {%d, %2d /* %s */},' % (width, class_idx[lbc], lbc)
+    print >>fp, '};'
+    print >>fp, ''
+
+    flat = []
+    for block in blocks:
+        flat.extend(block)
+    printarray(fp, 'unsigned char', 'lbprop_blocks', flat)
+    flat = []
+    for mid in mids:
+        flat.extend(mid)
+    printarray(fp, 'unsigned short', 'lbprop_index2', flat)
+    for suffix, index1 in index1s:
+        printarray(fp, index1type, 'lbprop%s_index1' % suffix, index1)
+
+    print >>fp, """\
+static const lbprop_value *find_lbprop(const %(index1type)s *index1,
+                                       linefold_char c)
+{
+	unsigned long u = (unsigned long)c;
+	unsigned int i;
+
+	if (LBPROP_MAX < u)
+		return lbprop_values;
+	i = lbprop_index2[((unsigned int)index1[u >> LBPROP_SHIFT1]
+	                   << (LBPROP_SHIFT1 - LBPROP_SHIFT2)) +
+	                  ((u >> LBPROP_SHIFT2) &
+	                   ((1 << (LBPROP_SHIFT1 - LBPROP_SHIFT2)) - 1))];
+	return lbprop_values + lbprop_blocks[(i << LBPROP_SHIFT2) +
+	                                     (u & ((1 << LBPROP_SHIFT2) - 1))];
+}
+
+/* Neighboring characters usually share a block: look it up once. */
+static void find_lbprop_bulk(const %(index1type)s *index1,
+                             const linefold_char *text, size_t len,
+                             linefold_width *widths, linefold_class *lbclasses)
+{
+	const unsigned char *block = lbprop_blocks;
+	const lbprop_value *ucp;
+	unsigned long u, blk = (unsigned long)-1;
+	size_t n;
+
+	for (n = 0; n < len; n++) {
+		u = (unsigned long)text[n];
+		if ((u >> LBPROP_SHIFT2) == blk)
+			ucp = lbprop_values + block[u & ((1 << LBPROP_SHIFT2) - 1)];
+		else if (LBPROP_MAX < u)
+			ucp = lbprop_values;
+		else {
+			blk = u >> LBPROP_SHIFT2;
+			block = lbprop_blocks +
+			    ((unsigned int)lbprop_index2[
+			        ((unsigned int)index1[u >> LBPROP_SHIFT1]
+			         << (LBPROP_SHIFT1 - LBPROP_SHIFT2)) +
+			        (blk & ((1 << (LBPROP_SHIFT1 - LBPROP_SHIFT2)) - 1))]
+			     << LBPROP_SHIFT2);
+			ucp = lbprop_values + block[u & ((1 << LBPROP_SHIFT2) - 1)];
+		}
+		if (widths)
+			widths[n] = ucp->width;
+		if (lbclasses)
+			lbclasses[n] = ucp->lbclass;
+	}
+}
+""" % {'index1type': index1type, }
+
 def generate_lbclass_pair(classes, lbrules):
     table = {}
     rulemap = {}
@@ -176,25 +333,19 @@ def generate_lbclass_pair(classes, lbrules):
             rulemap[obefore][oafter] = rules
     return table, rulemap
 
+ACTIONSYMS = {
+    DIRECT: 'D',
+    INDIRECT: 'I',
+    COMBINING_INDIRECT: 'Ic',
+    COMBINING_PROHIBITED: 'Xc',
+    PROHIBITED: 'X',
+    }
+
 def printpairtable(fp, classes, table, rulemap):
     for before in classes:
         fp.write('static const linefold_action row_%s[] =\n  {' % before)
-        for after in classes:
-            r = table[before][after]
-            if r == DIRECT:
-                fp.write('D')
-            elif r == INDIRECT:
-                fp.write('I')
-            elif r == COMBINING_INDIRECT:
-                fp.write('Ic')
-            elif r == COMBINING_PROHIBITED:
-                fp.write('Xc')
-            elif r == PROHIBITED:
-                fp.write('X')
-            else:
-                fp.write('?')
-            if after <> classes[-1]:
-                fp.write(',')
+        fp.write(','.join([ACTIONSYMS.get(table[before][after], '?')
+                           for after in classes]))
         fp.write('};\n')
     print >>fp, '''
 const linefold_action *linefold_lbpairs[] = 
@@ -203,6 +354,19 @@ const linefold_action *linefold_lbpairs[] =
 };
 ''' % ',\n  '.join(['row_'+c for c in classes])
 
+    print >>fp, '''\
+/* Same table packed into a matrix of bytes, for use by the library. */
+const unsigned char linefold_lbpairs_packed[%d * %d] =
+{''' % (len(classes), len(classes))
+    for before in classes:
+        fp.write('  /* %-5s */ ' % before)
+        fp.write(','.join([ACTIONSYMS[table[before][after]]
+                           for after in classes]))
+        if before <> classes[-1]:
+            fp.write(',')
+        fp.write('\n')
+    print >>fp, '};\n'
+
 
 def fmtrule(ruletuple):
     rulename, r, before, after = ruletuple
@@ -44,6 +44,10 @@
 extern int errno;
 #endif /* errno */
 
+#if USE_PTHREAD
+#    include <pthread.h>
+#endif /* USE_PTHREAD */
+
 #if !HAVE_STRERROR
 extern char *strerror(int);
 #endif
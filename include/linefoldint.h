@@ -0,0 +1,86 @@
+/*
+ * Definitions shared by modules of the linefold library.
+ *
+ * Copyright (C) 2006 by Hatuka*nezumi - IKEDA Soji.  All rights reserved.
+ *
+ * This file is part of the Linefold Package.  This program is free
+ * software; you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.  This program is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the COPYING file for more details.
+ *
+ * $Id$
+ */
+
+#ifndef LINEFOLDINT_H
+#define LINEFOLDINT_H
+
+/*
+ * Cache of tailored character properties (linefoldcache.c).
+ *
+ * Properties of characters below PROPCACHE_LIMIT, got by a property
+ * function then tailored by linefold_tailor_lbprop(), are held in
+ * two-stage tables.  Properties of other characters are not cached.
+ */
+#define PROPCACHE_LIMIT 0x20000
+#define PROPCACHE_SHIFT 7
+#define PROPCACHE_BLOCKSIZE (1 << PROPCACHE_SHIFT)
+#define PROPCACHE_INDEXSIZE (PROPCACHE_LIMIT >> PROPCACHE_SHIFT)
+#define PROPCACHE_MAXVALUES 0x100
+
+struct linefold_propcache
+{
+  linefold_lbprop_funcptr lbprop_func;  /* key: property function */
+  linefold_flags flags;                 /* key: options */
+  unsigned short *index;                /* block number of each block */
+  unsigned char *blocks;                /* value number of each char */
+  linefold_width widths[PROPCACHE_MAXVALUES];
+  linefold_class lbclasses[PROPCACHE_MAXVALUES];
+  struct linefold_propcache *next;
+};
+
+extern const struct linefold_propcache *
+linefold_propcache_get(linefold_lbprop_funcptr, linefold_flags);
+
+/* Get value number of character c, which must be below PROPCACHE_LIMIT. */
+#define PROPCACHE_VALUE(cache, c)					\
+  ((cache)->blocks[((size_t)(cache)->index[(size_t)(c) >> PROPCACHE_SHIFT]	\
+		    << PROPCACHE_SHIFT) +					\
+		   ((size_t)(c) & (PROPCACHE_BLOCKSIZE - 1))])
+
+/*
+ * Pair table packed into bytes (linefoldtab.c).  Same as linefold_lbpairs.
+ */
+extern const unsigned char
+linefold_lbpairs_packed[LINEFOLD_LBPAIRS_SIZE * LINEFOLD_LBPAIRS_SIZE];
+
+#define LBPAIR_ACTION(before, after)					\
+  ((linefold_action)							\
+   linefold_lbpairs_packed[(size_t)(before) * LINEFOLD_LBPAIRS_SIZE +	\
+			   (size_t)(after)])
+
+/*
+ * Classification of ASCII runs (linefoldsimd.c).
+ *
+ * Gets properties of leading ASCII characters in text by looking up
+ * tables of ASCII_TABSIZE entries, and returns number of them.
+ */
+#define ASCII_TABSIZE 0x80
+
+extern size_t
+linefold_ascii_props(const linefold_char *, size_t,
+		     const linefold_width *, const linefold_class *,
+		     linefold_width *, linefold_class *);
+
+/* Kernels are 0: scalar, 1: SSE2, 2: AVX2; these are used by tests. */
+extern int
+linefold_ascii_kernel(void);
+extern size_t
+linefold_ascii_props_kernel(int, const linefold_char *, size_t,
+			    const linefold_width *, const linefold_class *,
+			    linefold_width *, linefold_class *);
+
+#endif /* LINEFOLDINT_H */
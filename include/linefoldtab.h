@@ -50,6 +50,7 @@ extern const linefold_class LINEFOLD_CLASS_CLHSP;
 
 /* Placeholder to indicate end of ordinal classes. */
 extern const linefold_class LINEFOLD_CLASS_TABLESIZE;
+#define LINEFOLD_LBPAIRS_SIZE 31
 
 /*
  * Below from here shouldn't appear in linefold_lbpairs[][] table.
@@ -91,5 +92,15 @@ extern void linefold_getprop_J(linefold_char,
                                linefold_width *, linefold_class *);
 extern void linefold_getprop_K(linefold_char,
                                linefold_width *, linefold_class *);
+extern void linefold_getprop_bulk_generic(const linefold_char *, size_t,
+                                          linefold_width *, linefold_class *);
+extern void linefold_getprop_bulk_C(const linefold_char *, size_t,
+                                    linefold_width *, linefold_class *);
+extern void linefold_getprop_bulk_G(const linefold_char *, size_t,
+                                    linefold_width *, linefold_class *);
+extern void linefold_getprop_bulk_J(const linefold_char *, size_t,
+                                    linefold_width *, linefold_class *);
+extern void linefold_getprop_bulk_K(const linefold_char *, size_t,
+                                    linefold_width *, linefold_class *);
 
 #endif /* LINEFOLDTAB_H */
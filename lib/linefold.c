@@ -18,12 +18,321 @@
 
 #include <assert.h>
 #include "common.h"
+#if HAVE_UNISTD_H
+#    include <unistd.h>
+#endif /* HAVE_UNISTD_H */
 #include "linefold.h"
+#include "linefoldint.h"
 
+/* Runs of ASCII at least this long are classified by table. */
+#define ASCII_MINRUN 8
+/* Number of characters processed at once in compact layout. */
+#define COMPACT_CHUNK 1024
+/* Number of characters fed into stream at once. */
+#define STREAM_CHUNK 4096
+/* Number of characters shared among threads at once; pieces of text
+   end at explicit breaks where needed, so they may be longer. */
+#define PARALLEL_CHUNK 65536
+/* Maximum number of threads sharing work. */
+#define PARALLEL_MAXTHREADS 256
+/* Characters a stream buffers per thread before they are worked on. */
+#define STREAM_BATCH (PARALLEL_CHUNK * 4)
+/* Characters at the head of a piece whose actions found from a guessed
+   state may be found again. */
+#define SPECULATE_WINDOW 256
+/* Largest character decoded from UTF-8. */
+#define UTF8_MAXCHAR ((sizeof(linefold_char) < 4)? 0xFFFFUL: 0x10FFFFUL)
+
+/* Function to determine excess of line, and its state.  If neither of
+   the first two is set, the last one is called with UTF-8 text. */
+struct fold_excess
+{
+  int (*is_line_excess)(const struct linefold_info *,
+			const linefold_char *,
+			size_t, size_t, size_t, void *);
+  int (*is_line_excess_incr)(const struct linefold_info *,
+			     const linefold_char *, struct linefold_fit *,
+			     size_t, size_t, size_t, void *);
+  struct linefold_fit fit;
+  int (*is_line_excess_utf8)(const struct linefold_info *, const char *,
+			     size_t, size_t, size_t, void *);
+  const char *text8;
+  size_t line, line8;                   /* start of current line, and its
+					   byte offset */
+  size_t pos, pos8;                     /* character converted last, and
+					   its byte offset */
+};
+
+/* State of find_linebreak_range() between ranges. */
+struct linebreak_state
+{
+  linefold_class before;        /* class of 'before' character, or -1 */
+  size_t linestart;             /* index of start of current line */
+};
+
+/* Line fitted by a thread. */
+struct parallel_line
+{
+  size_t end;                           /* last character of the line */
+  linefold_action action;
+};
+
+/* Piece of text shared among threads, and lines found in it. */
+struct parallel_piece
+{
+  size_t start, end;                    /* characters from start to end
+					   (exclusive) */
+  enum {
+    PIECE_WAITING, PIECE_RUNNING, PIECE_DONE, PIECE_FAILED
+  } state;
+  struct parallel_line *lines;
+  size_t nlines;
+  struct linebreak_state guess;         /* state after the piece, found
+					   from a guessed state */
+};
+
+/* Pieces of a thread: it takes them from the head, and other threads
+   having none steal them from the tail. */
+struct parallel_deque
+{
+  size_t head, tail;                    /* pieces from head to tail
+					   (exclusive) */
+};
+
+/*
+ * Work shared among threads by linefold_alloc_parallel(),
+ * linefold_parallel() and streams.  Each thread is given pieces in a
+ * row, so that a thread left by large pieces will be helped.
+ */
+struct parallel_work
+{
+  struct linefold_info *lbinfo;
+  struct linefold_info info;            /* copy of lbinfo not modified
+					   while threads run */
+  const linefold_char *text;
+  linefold_lbprop_funcptr lbprop_func;
+  void (*tailor_lbprop)(linefold_char, linefold_width *, linefold_class *,
+			linefold_flags);
+  struct fold_excess excess;
+  void (*writeout_cb)(const struct linefold_info *, const linefold_char *,
+		      size_t, size_t, linefold_action, void *);
+  size_t maxlen;
+  void *voidarg;
+  linefold_action global_action;
+  struct linebreak_state state;         /* state before the first piece */
+  struct linebreak_state *guesses;      /* states after each of characters
+					   at the head of pieces, found
+					   from guessed ones */
+  struct parallel_piece *pieces;
+  size_t npieces;
+  struct parallel_deque deques[PARALLEL_MAXTHREADS];
+  int nthreads;
+#if USE_PTHREAD
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;                  /* signaled when a piece is
+					   finished */
+#endif /* USE_PTHREAD */
+};
+
+/* Argument given to each of threads. */
+struct parallel_thread
+{
+  struct parallel_work *work;
+  int self;                             /* index of its deque */
+};
+
+#if USE_PTHREAD
+/* Threads started by parallel_run() which wait there for next work. */
+struct parallel_pooled
+{
+  pthread_t tid;
+  pthread_cond_t cond;                  /* signaled when work is given */
+  void *(*worker)(void *);              /* work given, or NULL */
+  struct parallel_thread *arg;
+  int *pending;                         /* threads still working with it */
+  struct parallel_pooled *next;         /* next idle thread */
+};
+#endif /* USE_PTHREAD */
+
+/*
+ * Streaming context.  Buffers hold characters from start of unfinished
+ * line; offsets are relative to it.
+ */
+struct linefold_stream
+{
+  struct linefold_info lbinfo;          /* points to buffers below */
+  linefold_lbprop_funcptr lbprop_func;
+  void (*tailor_lbprop)(linefold_char, linefold_width *, linefold_class *,
+			linefold_flags);
+  struct fold_excess excess;
+  void (*writeout_cb)(const struct linefold_info *, const linefold_char *,
+		      size_t, size_t, linefold_action, void *);
+  size_t maxlen;
+  void *voidarg;
+  struct linebreak_state state;
+  linefold_action global_action;
+  linefold_char *text;
+  linefold_width *widths;
+  linefold_class *lbclasses;
+  linefold_action *lbactions;
+  size_t len;                           /* number of buffered characters */
+  size_t size;                          /* size of buffers */
+  size_t classified;                    /* characters whose properties are
+					   got */
+  size_t analyzed;                      /* characters whose actions are
+					   found; if 0, buffer starts a
+					   paragraph */
+  int nthreads;                         /* threads to work on buffer */
+};
+
+/* Number of threads used unless specified.  See linefold_set_jobs(). */
+static int default_jobs = 1;
+
+#if USE_PTHREAD
+/* Threads kept by parallel_run() for later calls.  Any caller takes as
+   many idle ones as it needs, and starts more if they are too few. */
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+static struct parallel_pooled *pool_idle = NULL;
+static int pool_threads = 0;
+#endif /* USE_PTHREAD */
+
+static struct linefold_info *
+alloc_info(const linefold_char *, const char *, size_t, size_t,
+	   linefold_lbprop_funcptr (*)(const char *, linefold_flags),
+	   void (*)(linefold_char, linefold_width *, linefold_class *,
+		    linefold_flags),
+	   const char *, linefold_flags, int);
+static void
+getprop_tailored(linefold_lbprop_funcptr, const linefold_char *, size_t,
+		 linefold_width *, linefold_class *, linefold_flags);
+static linefold_action
+fold_text(struct linefold_info *, const linefold_char *, struct fold_excess *,
+	  void (*)(const struct linefold_info *, const linefold_char *,
+		   size_t, size_t, linefold_action, void *),
+	  size_t, void *);
+static void
+emit_line(struct linefold_info *, const linefold_char *, size_t, size_t,
+	  linefold_action,
+	  void (*)(const struct linefold_info *, const linefold_char *,
+		   size_t, size_t, linefold_action, void *),
+	  void *, linefold_action *);
+static void
+next_line_index(struct linefold_info *, linefold_action);
 static size_t
-find_linebreak(size_t, linefold_class *, linefold_action *, linefold_flags);
+fit_line(const struct linefold_info *, const linefold_char *, size_t,
+	 struct fold_excess *, size_t, void *, linefold_action *);
+static void
+stream_fold(struct linefold_stream *, size_t, int);
+static void
+stream_discard(struct linefold_stream *, size_t);
+static void
+stream_batch(struct linefold_stream *, int);
+static void
+stream_sequential(struct linefold_stream *, struct parallel_work *, int);
+static size_t
+stream_paragraph_end(struct linefold_stream *, size_t, int, int);
+static int
+stream_reserve(struct linefold_stream *, size_t);
+static size_t
+force_fit(const struct linefold_info *, const linefold_char *,
+	  struct fold_excess *, size_t, size_t, size_t, void *);
+static int
+line_excess(const struct linefold_info *, const linefold_char *,
+	    struct fold_excess *, size_t, size_t, size_t, void *);
+static size_t
+utf8_offset(const struct linefold_info *, struct fold_excess *, size_t);
+static int
+is_combined_jamo(const struct linefold_info *, size_t, size_t);
+static size_t
+span_real_width(const struct linefold_info *, size_t, size_t);
+static int
+build_widthsums(struct linefold_info *);
+static void
+getprop_text(linefold_lbprop_funcptr,
+	     void (*)(linefold_char, linefold_width *, linefold_class *,
+		      linefold_flags),
+	     const linefold_char *, size_t,
+	     linefold_width *, linefold_class *, linefold_flags);
+static int
+getprop_compact(linefold_lbprop_funcptr,
+		void (*)(linefold_char, linefold_width *, linefold_class *,
+			 linefold_flags),
+		const linefold_char *, size_t,
+		signed char *, unsigned char *, linefold_flags);
+static size_t
+find_linebreak(struct linefold_info *);
+static size_t
+find_linebreak_span(struct linefold_info *, size_t, size_t, linefold_action);
+static void
+find_linebreak_info(struct linefold_info *, struct linebreak_state *,
+		    size_t, size_t, size_t);
+static void
+linebreak_init(struct linebreak_state *);
+static int
+linebreak_agree(const struct linebreak_state *,
+		const struct linebreak_state *, size_t);
+static void
+find_linebreak_range(struct linebreak_state *,
+		     const linefold_class *, linefold_action *,
+		     size_t, size_t, size_t, linefold_flags);
+static int
+getprop_utf8(linefold_lbprop_funcptr,
+	     void (*)(linefold_char, linefold_width *, linefold_class *,
+		      linefold_flags),
+	     const char *, size_t, struct linefold_info *);
+static size_t
+utf8_getc(const unsigned char *, const unsigned char *, linefold_char *);
+static size_t
+utf8_skip(const struct linefold_info *, const char *, size_t, size_t);
 static int
 charsetcmp(const char *, const char *);
+static struct linefold_info *
+alloc_arrays(size_t, const char *, linefold_flags, int);
+static void
+parallel_init(struct parallel_work *, struct linefold_info *,
+	      const linefold_char *, int);
+static void
+parallel_destroy(struct parallel_work *);
+static int
+parallel_split(struct parallel_work *, size_t, size_t,
+	       int (*)(const struct linefold_info *, size_t));
+static void
+parallel_run(struct parallel_work *, void *(*)(void *), void *(*)(void *));
+#if USE_PTHREAD
+static void *
+pool_main(void *);
+#endif /* USE_PTHREAD */
+static struct parallel_piece *
+parallel_take(struct parallel_work *, int);
+static void
+parallel_finish(struct parallel_work *, struct parallel_piece *, int);
+static int
+is_paragraph_end(const struct linefold_info *, size_t);
+static int
+is_explicit_break(const struct linefold_info *, size_t);
+static void *
+getprop_worker(void *);
+static void *
+linebreak_worker(void *);
+static void
+find_linebreak_parallel(struct parallel_work *, struct linebreak_state *,
+			size_t, size_t);
+static int
+repair_piece(struct parallel_work *, struct linebreak_state *,
+	     struct parallel_piece *);
+static void *
+fold_worker(void *);
+static void *
+emit_pieces(void *);
+static int
+fit_piece(struct parallel_work *, struct parallel_piece *);
+static linefold_action
+fold_parallel(struct linefold_info *, const linefold_char *,
+	      struct fold_excess *,
+	      void (*)(const struct linefold_info *, const linefold_char *,
+		       size_t, size_t, linefold_action, void *),
+	      size_t, void *, int);
 
 /*
  * Public Functions
@@ -39,261 +348,2170 @@ linefold_alloc(const linefold_char *text, size_t textlen,
 				     linefold_flags),
 	       const char *chset, linefold_flags flags)
 {
-  struct linefold_info *lbinfo;
-  linefold_width *widths;
-  linefold_class *lbclasses;
-  linefold_action *lbactions;
-  char *charset=NULL;
-  size_t i;
-  linefold_lbprop_funcptr lbprop_func;
+  return linefold_alloc_ex(text, textlen, find_lbprop_func, tailor_lbprop,
+			   chset, flags, LINEFOLD_INFO_DEFAULT);
+}
+
+/* Allocate line break informations in specified layout. */
+struct linefold_info *
+linefold_alloc_ex(const linefold_char *text, size_t textlen,
+		  linefold_lbprop_funcptr
+		  (*find_lbprop_func)(const char *, linefold_flags),
+		  void (*tailor_lbprop)(linefold_char,
+					linefold_width *, linefold_class *,
+					linefold_flags),
+		  const char *chset, linefold_flags flags, int layout)
+{
+  if (text == NULL || textlen == 0)
+    return NULL;
+  /* Only built-in functions are called from threads implicitly. */
+  if (1 < default_jobs &&
+      (find_lbprop_func == NULL ||
+       find_lbprop_func == &linefold_find_lbprop_func) &&
+      (tailor_lbprop == NULL || tailor_lbprop == &linefold_tailor_lbprop))
+    return linefold_alloc_parallel(text, textlen, find_lbprop_func,
+				   tailor_lbprop, chset, flags, layout, 0);
+  return alloc_info(text, NULL, textlen, 0, find_lbprop_func, tailor_lbprop,
+		    chset, flags, layout);
+}
+
+/* Allocate line break informations of UTF-8 text. */
+struct linefold_info *
+linefold_alloc_utf8(const char *text, size_t textlen,
+		    linefold_lbprop_funcptr
+		    (*find_lbprop_func)(const char *, linefold_flags),
+		    void (*tailor_lbprop)(linefold_char,
+					  linefold_width *, linefold_class *,
+					  linefold_flags),
+		    const char *chset, linefold_flags flags, int layout)
+{
+  const unsigned char *p, *end;
+  size_t len;
+
+  if (text == NULL || textlen == 0)
+    return NULL;
+
+  /* Count characters. */
+  p = (const unsigned char *)text;
+  end = p + textlen;
+  for (len = 0; p < end; len++)
+    p += (*p < 0x80)? 1: utf8_getc(p, end, NULL);
+
+  return alloc_info(NULL, text, len, textlen, find_lbprop_func,
+		    tailor_lbprop, chset, flags, layout);
+}
+
+/*
+ * Allocate line break informations of len characters, given by either
+ * text or UTF-8 text8 of len8 bytes.
+ */
+static struct linefold_info *
+alloc_info(const linefold_char *text, const char *text8, size_t textlen,
+	   size_t len8,
+	   linefold_lbprop_funcptr
+	   (*find_lbprop_func)(const char *, linefold_flags),
+	   void (*tailor_lbprop)(linefold_char,
+				 linefold_width *, linefold_class *,
+				 linefold_flags),
+	   const char *chset, linefold_flags flags, int layout)
+{
+  struct linefold_info *lbinfo;
+  linefold_lbprop_funcptr lbprop_func;
+
+  if ((lbinfo = alloc_arrays(textlen, chset, flags, layout)) == NULL)
+    return NULL;
+
+  if (find_lbprop_func == NULL)
+    find_lbprop_func = &linefold_find_lbprop_func;
+  if (tailor_lbprop == NULL)
+    tailor_lbprop = &linefold_tailor_lbprop;
+  lbprop_func = (*find_lbprop_func)(lbinfo->charset, flags);
+
+  if ((text8 != NULL &&
+       getprop_utf8(lbprop_func, tailor_lbprop, text8, len8, lbinfo) == 0) ||
+      (text8 == NULL && (layout & LINEFOLD_INFO_COMPACT) &&
+       getprop_compact(lbprop_func, tailor_lbprop, text, textlen,
+		       (signed char *)lbinfo->widths8,
+		       (unsigned char *)lbinfo->lbclasses8, flags) == 0)) {
+    linefold_free(lbinfo);
+    return NULL;
+  }
+  if (text8 == NULL && !(layout & LINEFOLD_INFO_COMPACT))
+    getprop_text(lbprop_func, tailor_lbprop, text, textlen,
+		 (linefold_width *)lbinfo->widths,
+		 (linefold_class *)lbinfo->lbclasses, flags);
+
+  if (find_linebreak(lbinfo) == 0 ||
+      ((layout & LINEFOLD_INFO_WIDTH_INDEX) &&
+       build_widthsums(lbinfo) == 0)) {
+    linefold_free(lbinfo);
+    return NULL;
+  }
+  return lbinfo;
+}
+
+/* Allocate line break informations of textlen characters, with arrays
+   of properties left undefined. */
+static struct linefold_info *
+alloc_arrays(size_t textlen, const char *chset, linefold_flags flags,
+	     int layout)
+{
+  struct linefold_info *lbinfo;
+  char *charset=NULL;
+  size_t i;
+
+  if ((lbinfo = malloc(sizeof(struct linefold_info))) == NULL)
+    return NULL;
+  lbinfo->widths = NULL;
+  lbinfo->lbclasses = NULL;
+  lbinfo->lbactions = NULL;
+  lbinfo->widths8 = NULL;
+  lbinfo->lbclasses8 = NULL;
+  lbinfo->lbactions8 = NULL;
+  lbinfo->widthsums = NULL;
+  lbinfo->utf8offsets = NULL;
+  lbinfo->charset = NULL;
+  lbinfo->length = textlen;
+  lbinfo->flags = flags;
+  lbinfo->linp = lbinfo->lint = lbinfo->pint = 0;
+
+  if (chset && *chset) {
+    if ((charset = malloc(strlen(chset)+1)) == NULL) {
+      linefold_free(lbinfo);
+      return NULL;
+    }
+    memcpy(charset, chset, strlen(chset)+1);
+    lbinfo->charset = charset;
+  }
+
+  if (layout & LINEFOLD_INFO_COMPACT) {
+    if ((lbinfo->widths8 = malloc(textlen)) == NULL ||
+	(lbinfo->lbclasses8 = malloc(textlen)) == NULL ||
+	(lbinfo->lbactions8 = malloc(textlen)) == NULL) {
+      linefold_free(lbinfo);
+      return NULL;
+    }
+    memset((void *)lbinfo->lbactions8, LINEFOLD_ACTION_PROHIBITED, textlen);
+  } else {
+    linefold_action *lbactions;
+
+    if ((lbinfo->widths = malloc(sizeof(linefold_width) * textlen))
+	== NULL ||
+	(lbinfo->lbclasses = malloc(sizeof(linefold_class) * textlen))
+	== NULL ||
+	(lbinfo->lbactions = lbactions =
+	 malloc(sizeof(linefold_action) * textlen)) == NULL) {
+      linefold_free(lbinfo);
+      return NULL;
+    }
+    for (i=0; i < textlen; i++)
+      lbactions[i] = LINEFOLD_ACTION_PROHIBITED;
+  }
+  return lbinfo;
+}
+
+void linefold_free(struct linefold_info *lbinfo)
+{
+  if (lbinfo == NULL)
+    return;
+
+  free((void *)lbinfo->widths);
+  free((void *)lbinfo->lbclasses);
+  free((void *)lbinfo->lbactions);
+  free((void *)lbinfo->widths8);
+  free((void *)lbinfo->lbclasses8);
+  free((void *)lbinfo->widthsums);
+  free((void *)lbinfo->utf8offsets);
+  free((void *)lbinfo->lbactions8);
+  if (lbinfo->charset) free((void *)lbinfo->charset);
+  free(lbinfo);
+}
+
+/* Do line breaking */
+linefold_action
+linefold(struct linefold_info *lbinfo, linefold_char *text,
+	 int (*is_line_excess)(const struct linefold_info *,
+			       const linefold_char *,
+			       size_t, size_t, size_t, void *),
+	 void (*writeout_cb)(const struct linefold_info *,
+			     const linefold_char *,
+			     size_t, size_t, linefold_action, void *),
+	 size_t maxlen, void *voidarg)
+{
+  struct fold_excess excess;
+
+  /* Built-in function is measured incrementally. */
+  if (is_line_excess == NULL)
+    excess.is_line_excess_incr = &linefold_is_line_excess_incr;
+  else
+    excess.is_line_excess_incr = NULL;
+  excess.is_line_excess = is_line_excess;
+  if (1 < default_jobs && is_line_excess == NULL)
+    return fold_parallel(lbinfo, text, &excess, writeout_cb, maxlen,
+			 voidarg, default_jobs);
+  return fold_text(lbinfo, text, &excess, writeout_cb, maxlen, voidarg);
+}
+
+/* Do line breaking measuring lines incrementally */
+linefold_action
+linefold_ex(struct linefold_info *lbinfo, linefold_char *text,
+	    int (*is_line_excess_incr)(const struct linefold_info *,
+				       const linefold_char *,
+				       struct linefold_fit *,
+				       size_t, size_t, size_t, void *),
+	    void (*writeout_cb)(const struct linefold_info *,
+				const linefold_char *,
+				size_t, size_t, linefold_action, void *),
+	    size_t maxlen, void *voidarg)
+{
+  struct fold_excess excess;
+
+  if (is_line_excess_incr == NULL)
+    is_line_excess_incr = &linefold_is_line_excess_incr;
+  excess.is_line_excess_incr = is_line_excess_incr;
+  excess.is_line_excess = NULL;
+  if (1 < default_jobs &&
+      is_line_excess_incr == &linefold_is_line_excess_incr)
+    return fold_parallel(lbinfo, text, &excess, writeout_cb, maxlen,
+			 voidarg, default_jobs);
+  return fold_text(lbinfo, text, &excess, writeout_cb, maxlen, voidarg);
+}
+
+/*
+ * Initialize cursor to get broken lines of text one by one.  Arguments
+ * are same as linefold_ex() takes, except writeout_cb.
+ */
+void
+linefold_iter_init(struct linefold_iter *iter,
+		   struct linefold_info *lbinfo, const linefold_char *text,
+		   int (*is_line_excess_incr)(const struct linefold_info *,
+					      const linefold_char *,
+					      struct linefold_fit *,
+					      size_t, size_t, size_t, void *),
+		   size_t maxlen, void *voidarg)
+{
+  if (iter == NULL)
+    return;
+
+  if (is_line_excess_incr == NULL)
+    is_line_excess_incr = &linefold_is_line_excess_incr;
+  iter->lbinfo = lbinfo;
+  iter->text = text;
+  iter->is_line_excess_incr = is_line_excess_incr;
+  iter->maxlen = maxlen;
+  iter->voidarg = voidarg;
+  linefold_iter_reset(iter);
+}
+
+/*
+ * Get the next broken line: its offset, length, line breaking action and
+ * width not including trailing spaces and newlines.  Any of pointers may
+ * be NULL.  Line indice of lbinfo are set to those of the line.  Returns
+ * 1, or 0 if no lines are left.
+ */
+int
+linefold_iter_next(struct linefold_iter *iter, size_t *startp,
+		   size_t *lenp, linefold_action *actionp, size_t *widthp)
+{
+  struct fold_excess excess;
+  struct linefold_info *lbinfo;
+  linefold_action action;
+  size_t start, end;
+
+  if (iter == NULL || iter->lbinfo == NULL ||
+      iter->lbinfo->length <= iter->pos)
+    return 0;
+  lbinfo = iter->lbinfo;
+
+  if (iter->pos != 0)
+    next_line_index(lbinfo, iter->action);
+  excess.is_line_excess = NULL;
+  excess.is_line_excess_incr = iter->is_line_excess_incr;
+  excess.fit = iter->fit;
+  start = iter->pos;
+  end = fit_line(lbinfo, iter->text, start, &excess, iter->maxlen,
+		 iter->voidarg, &action);
+  iter->fit = excess.fit;
+  iter->pos = end + 1;
+  iter->action = action;
+
+  /* Save line breaking action. */
+  if (action == LINEFOLD_ACTION_DIRECT ||
+      (action == LINEFOLD_ACTION_INDIRECT &&
+       iter->global_action != LINEFOLD_ACTION_DIRECT))
+    iter->global_action = action;
+
+  if (startp != NULL)
+    *startp = start;
+  if (lenp != NULL)
+    *lenp = end - start + 1;
+  if (actionp != NULL)
+    *actionp = action;
+  if (widthp != NULL)
+    *widthp = linefold_span_width(lbinfo, start, end - start + 1, NULL);
+  return 1;
+}
+
+/* Rewind cursor to the first line of text. */
+void
+linefold_iter_reset(struct linefold_iter *iter)
+{
+  if (iter == NULL)
+    return;
+
+  memset(&iter->fit, 0, sizeof(struct linefold_fit));
+  iter->pos = 0;
+  iter->action = LINEFOLD_ACTION_NOMOD;
+  iter->global_action = LINEFOLD_ACTION_NOMOD;
+  if (iter->lbinfo != NULL)
+    iter->lbinfo->linp = iter->lbinfo->lint = iter->lbinfo->pint = 0;
+}
+
+/* Allocate context to break lines of text given piece by piece. */
+struct linefold_stream *
+linefold_stream_alloc(linefold_lbprop_funcptr
+		      (*find_lbprop_func)(const char *, linefold_flags),
+		      void (*tailor_lbprop)(linefold_char,
+					    linefold_width *,
+					    linefold_class *,
+					    linefold_flags),
+		      const char *chset, linefold_flags flags,
+		      int (*is_line_excess_incr)(const struct linefold_info *,
+						 const linefold_char *,
+						 struct linefold_fit *,
+						 size_t, size_t, size_t,
+						 void *),
+		      void (*writeout_cb)(const struct linefold_info *,
+					  const linefold_char *,
+					  size_t, size_t, linefold_action,
+					  void *),
+		      size_t maxlen, void *voidarg)
+{
+  struct linefold_stream *stream;
+  char *charset=NULL;
+  int builtin;
+
+  if ((stream = malloc(sizeof(struct linefold_stream))) == NULL)
+    return NULL;
+  memset(stream, 0, sizeof(struct linefold_stream));
+  if (chset && *chset) {
+    if ((charset = malloc(strlen(chset)+1)) == NULL) {
+      free(stream);
+      return NULL;
+    }
+    memcpy(charset, chset, strlen(chset)+1);
+  }
+
+  if (find_lbprop_func == NULL)
+    find_lbprop_func = &linefold_find_lbprop_func;
+  if (tailor_lbprop == NULL)
+    tailor_lbprop = &linefold_tailor_lbprop;
+  if (is_line_excess_incr == NULL)
+    is_line_excess_incr = &linefold_is_line_excess_incr;
+  builtin = (find_lbprop_func == &linefold_find_lbprop_func &&
+	     tailor_lbprop == &linefold_tailor_lbprop &&
+	     is_line_excess_incr == &linefold_is_line_excess_incr);
+  stream->lbinfo.charset = charset;
+  stream->lbinfo.flags = flags;
+  stream->lbprop_func = (*find_lbprop_func)(charset, flags);
+  stream->tailor_lbprop = tailor_lbprop;
+  stream->excess.is_line_excess_incr = is_line_excess_incr;
+  stream->writeout_cb = writeout_cb;
+  stream->maxlen = maxlen;
+  stream->voidarg = voidarg;
+  stream->global_action = LINEFOLD_ACTION_NOMOD;
+  linebreak_init(&stream->state);
+#if USE_PTHREAD
+  /* Only built-in functions are called from threads implicitly. */
+  stream->nthreads = builtin? default_jobs: 1;
+#else /* USE_PTHREAD */
+  stream->nthreads = 1;
+#endif /* USE_PTHREAD */
+  return stream;
+}
+
+/*
+ * Feed a piece of text into stream.  Lines fixed so far are written out.
+ * Returns 0, or -1 if memory couldn't be allocated.
+ */
+int
+linefold_stream_feed(struct linefold_stream *stream,
+		     const linefold_char *text, size_t len)
+{
+  size_t n, i;
+
+  if (stream == NULL)
+    return -1;
+
+  /* Characters are buffered, then worked on by threads. */
+  while (1 < stream->nthreads && len) {
+    n = STREAM_BATCH * (size_t)stream->nthreads;
+    if (len < n)
+      n = len;
+    if (stream_reserve(stream, n) == 0)
+      return -1;
+
+    memcpy(stream->text + stream->len, text, sizeof(linefold_char) * n);
+    for (i = stream->len; i < stream->len + n; i++)
+      stream->lbactions[i] = LINEFOLD_ACTION_PROHIBITED;
+    stream->len += n;
+
+    if (STREAM_BATCH * (size_t)stream->nthreads <=
+	stream->len - stream->analyzed)
+      stream_batch(stream, 0);
+    text += n;
+    len -= n;
+  }
+
+  while (len) {
+    n = (len < STREAM_CHUNK)? len: STREAM_CHUNK;
+    if (stream_reserve(stream, n) == 0)
+      return -1;
+
+    memcpy(stream->text + stream->len, text, sizeof(linefold_char) * n);
+    getprop_text(stream->lbprop_func, stream->tailor_lbprop, text, n,
+		 stream->widths + stream->len,
+		 stream->lbclasses + stream->len, stream->lbinfo.flags);
+    for (i = stream->len; i < stream->len + n; i++)
+      stream->lbactions[i] = LINEFOLD_ACTION_PROHIBITED;
+    find_linebreak_range(&stream->state, stream->lbclasses,
+			 stream->lbactions, 0, stream->len, stream->len + n,
+			 stream->lbinfo.flags);
+    stream->len += n;
+    stream->classified = stream->analyzed = stream->len;
+
+    stream_fold(stream, (2 < stream->len)? stream->len - 2: 0, 0);
+    text += n;
+    len -= n;
+  }
+  return 0;
+}
+
+/*
+ * Write out the rest of text in stream, then reset it for another text.
+ * Returns the same value as linefold() does.
+ */
+linefold_action
+linefold_stream_finish(struct linefold_stream *stream)
+{
+  linefold_action global_action;
+
+  if (stream == NULL)
+    return LINEFOLD_ACTION_NOMOD;
+
+  if (stream->len && 1 < stream->nthreads)
+    stream_batch(stream, 1);
+  else if (stream->len) {
+    stream->lbactions[stream->len-1] = LINEFOLD_ACTION_EOT;
+    stream_fold(stream, stream->len, 1);
+  }
+  global_action = stream->global_action;
+
+  stream->len = stream->classified = stream->analyzed = 0;
+  stream->lbinfo.linp = stream->lbinfo.lint = stream->lbinfo.pint = 0;
+  stream->global_action = LINEFOLD_ACTION_NOMOD;
+  linebreak_init(&stream->state);
+  memset(&stream->excess.fit, 0, sizeof(struct linefold_fit));
+  return global_action;
+}
+
+void
+linefold_stream_free(struct linefold_stream *stream)
+{
+  if (stream == NULL)
+    return;
+
+  free((void *)stream->lbinfo.charset);
+  free(stream->text);
+  free(stream->widths);
+  free(stream->lbclasses);
+  free(stream->lbactions);
+  free(stream);
+}
+
+/*
+ * Do line breaking of UTF-8 text that lbinfo was allocated for by
+ * linefold_alloc_utf8().  Offsets and lengths given to is_line_excess and
+ * writeout_cb are in bytes.
+ */
+linefold_action
+linefold_utf8(struct linefold_info *lbinfo, const char *text,
+	      int (*is_line_excess)(const struct linefold_info *,
+				    const char *,
+				    size_t, size_t, size_t, void *),
+	      void (*writeout_cb)(const struct linefold_info *, const char *,
+				  size_t, size_t, linefold_action, void *),
+	      size_t maxlen, void *voidarg)
+{
+  struct fold_excess excess;
+  linefold_action global_action=LINEFOLD_ACTION_NOMOD, action;
+  size_t i=0, end, end8;
+
+  if (lbinfo == NULL || lbinfo->utf8offsets == NULL)
+    return LINEFOLD_ACTION_NOMOD;
+
+  memset(&excess, 0, sizeof(struct fold_excess));
+  /* Built-in function is measured incrementally. */
+  if (is_line_excess == NULL)
+    excess.is_line_excess_incr = &linefold_is_line_excess_incr;
+  excess.is_line_excess_utf8 = is_line_excess;
+  excess.text8 = text;
+
+  while (i < lbinfo->length) {
+    excess.line = i;
+    end = fit_line(lbinfo, NULL, i, &excess, maxlen, voidarg, &action);
+    end8 = utf8_skip(lbinfo, text, excess.line8, end - i + 1);
+    if (writeout_cb != NULL)
+      (*writeout_cb)(lbinfo, text, excess.line8, end8 - excess.line8,
+		     action, voidarg);
+    emit_line(lbinfo, NULL, i, end, action, NULL, voidarg, &global_action);
+    excess.line8 = end8;
+    i = end + 1;
+  }
+
+  return global_action;
+}
+
+/* Byte offset of i-th character of UTF-8 text, or length of text if i
+   is beyond the end. */
+size_t
+linefold_utf8_offset(const struct linefold_info *lbinfo, const char *text,
+		     size_t i)
+{
+  const size_t *offsets;
+
+  if (lbinfo == NULL || (offsets = lbinfo->utf8offsets) == NULL)
+    return 0;
+  if (lbinfo->length <= i)
+    return offsets[lbinfo->length / LINEFOLD_UTF8_STRIDE + 1];
+  return utf8_skip(lbinfo, text, offsets[i / LINEFOLD_UTF8_STRIDE],
+		   i % LINEFOLD_UTF8_STRIDE);
+}
+
+/* Index of character starting at byte offset off of UTF-8 text, or of
+   the next one if off is inside a character. */
+size_t
+linefold_utf8_index(const struct linefold_info *lbinfo, const char *text,
+		    size_t off)
+{
+  const size_t *offsets;
+  size_t lo, hi, mid, i, off8;
+
+  if (lbinfo == NULL || (offsets = lbinfo->utf8offsets) == NULL ||
+      off == 0)
+    return 0;
+  hi = lbinfo->length / LINEFOLD_UTF8_STRIDE + 1;
+  if (offsets[hi] <= off)
+    return lbinfo->length;
+
+  /* Last recorded character starting before off, by bisection. */
+  lo = 0;
+  while (lo + 1 < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (offsets[mid] < off)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  i = lo * LINEFOLD_UTF8_STRIDE;
+  for (off8 = offsets[lo]; off8 < off; i++)
+    off8 = utf8_skip(lbinfo, text, off8, 1);
+  return i;
+}
+
+/*
+ * Set number of threads used by linefold_alloc(), linefold() and so on,
+ * or by functions given 0 as number of threads.  If njobs is 0 or less,
+ * number of online processors is used.  Should be set before threads
+ * use the library.
+ */
+void
+linefold_set_jobs(int njobs)
+{
+  long n;
+
+  if (njobs <= 0) {
+#if HAVE_UNISTD_H && defined(_SC_NPROCESSORS_ONLN)
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    n = 1;
+#endif
+    njobs = (n < 1)? 1: (PARALLEL_MAXTHREADS < n)? PARALLEL_MAXTHREADS:
+      (int)n;
+  } else if (PARALLEL_MAXTHREADS < njobs)
+    njobs = PARALLEL_MAXTHREADS;
+  default_jobs = njobs;
+}
+
+int
+linefold_get_jobs(void)
+{
+  return default_jobs;
+}
+
+/*
+ * Allocate line break informations as linefold_alloc_ex() does, sharing
+ * work among nthreads threads including the caller.  Functions to get
+ * and tailor properties are called from any of them.
+ */
+struct linefold_info *
+linefold_alloc_parallel(const linefold_char *text, size_t textlen,
+			linefold_lbprop_funcptr
+			(*find_lbprop_func)(const char *, linefold_flags),
+			void (*tailor_lbprop)(linefold_char,
+					      linefold_width *,
+					      linefold_class *,
+					      linefold_flags),
+			const char *chset, linefold_flags flags, int layout,
+			int nthreads)
+{
+  struct parallel_work work;
+  struct linefold_info *lbinfo;
+  struct linebreak_state state;
+  size_t i;
+  int ok;
+
+  if (text == NULL || textlen == 0)
+    return NULL;
+  if (nthreads < 1)
+    nthreads = default_jobs;
+  if (nthreads == 1)
+    return alloc_info(text, NULL, textlen, 0, find_lbprop_func,
+		      tailor_lbprop, chset, flags, layout);
+  if ((lbinfo = alloc_arrays(textlen, chset, flags, layout)) == NULL)
+    return NULL;
+
+  if (find_lbprop_func == NULL)
+    find_lbprop_func = &linefold_find_lbprop_func;
+  if (tailor_lbprop == NULL)
+    tailor_lbprop = &linefold_tailor_lbprop;
+  parallel_init(&work, lbinfo, text, nthreads);
+  work.lbprop_func = (*find_lbprop_func)(lbinfo->charset, flags);
+  work.tailor_lbprop = tailor_lbprop;
+
+  /* Both properties and actions are found by pieces of any length. */
+  ok = parallel_split(&work, 0, textlen, NULL);
+  if (ok) {
+    parallel_run(&work, &getprop_worker, &getprop_worker);
+    for (i=0; i < work.npieces; i++)
+      if (work.pieces[i].state == PIECE_FAILED)
+	ok = 0;
+  }
+  if (ok) {
+    linebreak_init(&state);
+    find_linebreak_parallel(&work, &state, 0, textlen);
+    if (lbinfo->lbactions8 != NULL)
+      ((unsigned char *)lbinfo->lbactions8)[textlen-1] =
+	(unsigned char)LINEFOLD_ACTION_EOT;
+    else
+      ((linefold_action *)lbinfo->lbactions)[textlen-1] =
+	LINEFOLD_ACTION_EOT;
+  }
+  parallel_destroy(&work);
+
+  if (!ok ||
+      ((layout & LINEFOLD_INFO_WIDTH_INDEX) &&
+       build_widthsums(lbinfo) == 0)) {
+    linefold_free(lbinfo);
+    return NULL;
+  }
+  return lbinfo;
+}
+
+/*
+ * Do line breaking as linefold_ex() does, fitting lines of paragraphs by
+ * nthreads threads.  writeout_cb is called by the caller in order of
+ * lines.  is_line_excess_incr is called from any of threads with a copy
+ * of lbinfo, in which linp is valid but lint and pint are not.
+ */
+linefold_action
+linefold_parallel(struct linefold_info *lbinfo, const linefold_char *text,
+		  int (*is_line_excess_incr)(const struct linefold_info *,
+					     const linefold_char *,
+					     struct linefold_fit *,
+					     size_t, size_t, size_t, void *),
+		  void (*writeout_cb)(const struct linefold_info *,
+				      const linefold_char *,
+				      size_t, size_t, linefold_action,
+				      void *),
+		  size_t maxlen, void *voidarg, int nthreads)
+{
+  struct fold_excess excess;
+
+  if (is_line_excess_incr == NULL)
+    is_line_excess_incr = &linefold_is_line_excess_incr;
+  excess.is_line_excess_incr = is_line_excess_incr;
+  excess.is_line_excess = NULL;
+  return fold_parallel(lbinfo, text, &excess, writeout_cb, maxlen, voidarg,
+		       nthreads);
+}
+
+/* Get properties of characters in text, by bulk version of lbprop_func
+   if any.  */
+void
+linefold_getprop_bulk(linefold_lbprop_funcptr lbprop_func,
+		      const linefold_char *text, size_t len,
+		      linefold_width *widths, linefold_class *lbclasses)
+{
+  linefold_lbprop_bulk_funcptr bulk_func;
+  size_t i;
+
+  if ((bulk_func = linefold_find_lbprop_bulk_func(lbprop_func)) != NULL) {
+    (*bulk_func)(text, len, widths, lbclasses);
+    return;
+  }
+  for (i=0; i < len; i++)
+    (*lbprop_func)(text[i], widths? widths+i: NULL,
+		   lbclasses? lbclasses+i: NULL);
+}
+
+/*
+ * Width of len characters from start, not including trailing spaces and
+ * newlines.  If real_width isn't NULL, width including them is stored.
+ * Takes constant time if lbinfo has width index.
+ */
+size_t
+linefold_span_width(const struct linefold_info *lbinfo,
+		    size_t start, size_t len, size_t *real_width)
+{
+  size_t end, i;
+  linefold_class lbc;
+
+  if (lbinfo == NULL || lbinfo->length < start) {
+    if (real_width != NULL)
+      *real_width = 0;
+    return 0;
+  }
+  if (lbinfo->length - start < len)
+    len = lbinfo->length - start;
+  end = start + len;
+
+  if (real_width != NULL)
+    *real_width = span_real_width(lbinfo, start, end);
+  for (i = end; start < i; i--) {
+    lbc = LINEFOLD_LBCLASS(lbinfo, i-1);
+    if (lbc != LINEFOLD_CLASS_SP &&
+	lbc != LINEFOLD_CLASS_BK &&
+	lbc != LINEFOLD_CLASS_CR &&
+	lbc != LINEFOLD_CLASS_LF &&
+	lbc != LINEFOLD_CLASS_NL)
+      break;
+  }
+  return span_real_width(lbinfo, start, i);
+}
+
+/*
+ * Number of characters from start whose width including trailing spaces
+ * doesn't exceed width.  Takes logarithmic time if lbinfo has width
+ * index.
+ */
+size_t
+linefold_span_fit(const struct linefold_info *lbinfo,
+		  size_t start, size_t width)
+{
+  const size_t *sums;
+  size_t rest, lo, hi, mid, step, head, limit;
+
+  if (lbinfo == NULL || lbinfo->length < start)
+    return 0;
+  rest = lbinfo->length - start;
+
+  if (lbinfo->widthsums == NULL) {
+    size_t real_width = 0;
+
+    for (lo = 0; lo < rest; lo++) {
+      if (!is_combined_jamo(lbinfo, start, start+lo))
+	real_width += LINEFOLD_WIDTH(lbinfo, start+lo);
+      if (width < real_width)
+	break;
+    }
+    return lo;
+  }
+
+  /* Characters at the head may have width not counted in the index. */
+  sums = lbinfo->widthsums;
+  if (rest < 2 || width < (head = span_real_width(lbinfo, start, start+2))) {
+    for (lo = 0; lo < rest && lo < 2; lo++)
+      if (width < span_real_width(lbinfo, start, start+lo+1))
+	break;
+    return lo;
+  }
+
+  /* Gallop then bisect over the index: widthsums[lo] is within
+     the limit, widthsums[hi] isn't. */
+  limit = sums[start+2] + width - head;
+  lo = start+2;
+  for (step = 1; step <= start+rest - lo && sums[lo+step] <= limit; step *= 2)
+    lo += step;
+  hi = (step <= start+rest - lo)? lo+step: start+rest+1;
+  while (lo + 1 < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (sums[mid] <= limit)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return lo - start;
+}
+
+/*
+ * Private functions
+ */
+
+/* Internal default of function to find function that get properties of
+   a character.  */
+linefold_lbprop_funcptr
+linefold_find_lbprop_func(const char *chset, linefold_flags flags)
+{
+  if (chset == NULL || flags & LINEFOLD_OPTION_GENERIC_WIDTH)
+    return &linefold_getprop_generic;
+  else if (charsetcmp(chset, "CNS")==0 || /* not a charset name. */
+	   charsetcmp(chset, "BIG5")==0 ||
+	   charsetcmp(chset, "BIG5-ETEN")==0 ||
+	   charsetcmp(chset, "BIG5-HKSCS")==0 ||
+	   charsetcmp(chset, "EUC-TW")==0 ||
+	   charsetcmp(chset, "CP950")==0)
+    return &linefold_getprop_C;
+  else if (charsetcmp(chset, "GB")==0 || /* not a charset name */
+	   charsetcmp(chset, "EUC-CN")==0 ||
+	   charsetcmp(chset, "ISO-2022-CN")==0 ||
+	   charsetcmp(chset, "ISO-2022-CN-EXT")==0 ||
+	   charsetcmp(chset, "HZ")==0 ||
+	   charsetcmp(chset, "HZ-GB-2312")==0 ||
+	   charsetcmp(chset, "GB2312")==0 ||
+	   charsetcmp(chset, "GBK")==0 ||
+	   charsetcmp(chset, "GB18030")==0 ||
+	   charsetcmp(chset, "CP936")==0)
+    return &linefold_getprop_G;
+  else if (charsetcmp(chset, "JIS")==0 || /* not a charset name */
+	   charsetcmp(chset, "ISO-2022-JP")==0 ||
+	   charsetcmp(chset, "ISO-2022-JP-1")==0 ||
+	   charsetcmp(chset, "ISO-2022-JP-2")==0 ||
+	   charsetcmp(chset, "ISO-2022-JP-3")==0 ||
+	   charsetcmp(chset, "ISO-2022-JP-3-PLANE1")==0 ||
+	   charsetcmp(chset, "ISO-2022-JP-2004")==0 ||
+	   charsetcmp(chset, "ISO-2022-JP-2004-PLANE1")==0 ||
+	   charsetcmp(chset, "EUC-JP")==0 ||
+	   charsetcmp(chset, "EUC-JISX0213")==0 ||
+	   charsetcmp(chset, "EUC-JISX0213-PLANE1")==0 ||
+	   charsetcmp(chset, "EUC-JIS-2004")==0 ||
+	   charsetcmp(chset, "EUC-JIS-2004-PLANE1")==0 ||
+	   charsetcmp(chset, "SHIFT_JIS")==0 ||
+	   charsetcmp(chset, "SHIFT_JISX0213")==0 ||
+	   charsetcmp(chset, "SHIFT_JISX0213-PLANE1")==0 ||
+	   charsetcmp(chset, "SHIFT_JIS-2004")==0 ||
+	   charsetcmp(chset, "SHIFT_JIS-2004-PLANE1")==0 ||
+	   charsetcmp(chset, "CP932")==0 ||
+	   charsetcmp(chset, "CP942")==0 || /* IBM */
+	   charsetcmp(chset, "CP943")==0) /* IBM */
+    return &linefold_getprop_J;
+  else if (charsetcmp(chset, "KS")==0 || /* not a charset name */
+	   charsetcmp(chset, "ISO-2022-KR")==0 ||
+	   charsetcmp(chset, "EUC-KR")==0 ||
+	   charsetcmp(chset, "CP949")==0 ||
+	   charsetcmp(chset, "UHC")==0 ||
+	   charsetcmp(chset, "KS_C_5601-1987")==0)
+    return &linefold_getprop_K;
+  else
+    return &linefold_getprop_generic;
+}
+
+/* Break all lines of text. */
+static linefold_action
+fold_text(struct linefold_info *lbinfo, const linefold_char *text,
+	  struct fold_excess *excess,
+	  void (*writeout_cb)(const struct linefold_info *,
+			      const linefold_char *,
+			      size_t, size_t, linefold_action, void *),
+	  size_t maxlen, void *voidarg)
+{
+  size_t textlen;
+  linefold_action global_action=LINEFOLD_ACTION_NOMOD, action;
+  size_t i=0, end;
+
+  if (lbinfo == NULL)
+    return LINEFOLD_ACTION_NOMOD;
+  textlen = lbinfo->length;
+  memset(&excess->fit, 0, sizeof(struct linefold_fit));
+
+  while (i < textlen) {
+    end = fit_line(lbinfo, text, i, excess, maxlen, voidarg, &action);
+    emit_line(lbinfo, text, i, end, action, writeout_cb, voidarg,
+	      &global_action);
+    i = end + 1;
+  }
+
+  return global_action;
+}
+
+/* Break all lines of text as fold_text() does, fitting lines of
+   paragraphs by nthreads threads. */
+static linefold_action
+fold_parallel(struct linefold_info *lbinfo, const linefold_char *text,
+	      struct fold_excess *excess,
+	      void (*writeout_cb)(const struct linefold_info *,
+				  const linefold_char *,
+				  size_t, size_t, linefold_action, void *),
+	      size_t maxlen, void *voidarg, int nthreads)
+{
+  struct parallel_work work;
+  linefold_action global_action;
+
+  if (lbinfo == NULL)
+    return LINEFOLD_ACTION_NOMOD;
+
+  parallel_init(&work, lbinfo, text, nthreads);
+  if (work.nthreads == 1 ||
+      parallel_split(&work, 0, lbinfo->length, &is_explicit_break) == 0) {
+    parallel_destroy(&work);
+    return fold_text(lbinfo, text, excess, writeout_cb, maxlen, voidarg);
+  }
+  work.excess = *excess;
+  work.writeout_cb = writeout_cb;
+  work.maxlen = maxlen;
+  work.voidarg = voidarg;
+  parallel_run(&work, &fold_worker, &emit_pieces);
+  global_action = work.global_action;
+  parallel_destroy(&work);
+  return global_action;
+}
+
+/* Write out a broken line from start to end (inclusive), then update
+   line breaking action of the text and line indice. */
+static void
+emit_line(struct linefold_info *lbinfo, const linefold_char *text,
+	  size_t start, size_t end, linefold_action action,
+	  void (*writeout_cb)(const struct linefold_info *,
+			      const linefold_char *,
+			      size_t, size_t, linefold_action, void *),
+	  void *voidarg, linefold_action *global_actionp)
+{
+  /* Write out a broken line. */
+  if (writeout_cb != NULL)
+    (*writeout_cb)(lbinfo, text, start, end-start+1, action, voidarg);
+  /* Save line breaking action. */
+  if (action == LINEFOLD_ACTION_DIRECT ||
+      (action == LINEFOLD_ACTION_INDIRECT &&
+       *global_actionp != LINEFOLD_ACTION_DIRECT))
+    *global_actionp = action;
+
+  next_line_index(lbinfo, action);
+}
+
+/* Update line indice to the line following one broken by action. */
+static void
+next_line_index(struct linefold_info *lbinfo, linefold_action action)
+{
+  if (action == LINEFOLD_ACTION_EXPLICIT ||
+      action == LINEFOLD_ACTION_EOT) {
+    lbinfo->linp = 0;
+    lbinfo->lint++;
+    lbinfo->pint++;
+  } else {
+    lbinfo->linp++;
+    lbinfo->lint++;
+  }
+}
+
+/*
+ * Break lines in buffer of stream, then discard them.  Actions of
+ * characters before fixed must have been fixed.  Line ending just before
+ * unfixed ones may be longer: Such line is left unless complete is true.
+ */
+static void
+stream_fold(struct linefold_stream *stream, size_t fixed, int complete)
+{
+  struct linefold_info *lbinfo = &stream->lbinfo;
+  linefold_action action;
+  size_t i = 0, end;
+
+  lbinfo->widths = stream->widths;
+  lbinfo->lbclasses = stream->lbclasses;
+  lbinfo->lbactions = stream->lbactions;
+  lbinfo->length = fixed;
+  while (i < fixed) {
+    end = fit_line(lbinfo, stream->text, i, &stream->excess,
+		   stream->maxlen, stream->voidarg, &action);
+    if (!complete && fixed <= end + 1)
+      break;
+    emit_line(lbinfo, stream->text, i, end, action, stream->writeout_cb,
+	      stream->voidarg, &stream->global_action);
+    i = end + 1;
+  }
+  if (i != 0)
+    stream_discard(stream, i);
+}
+
+/* Discard first n characters in buffer of stream, written out. */
+static void
+stream_discard(struct linefold_stream *stream, size_t n)
+{
+  stream->len -= n;
+  memmove(stream->text, stream->text + n,
+	  sizeof(linefold_char) * stream->len);
+  memmove(stream->widths, stream->widths + n,
+	  sizeof(linefold_width) * stream->len);
+  memmove(stream->lbclasses, stream->lbclasses + n,
+	  sizeof(linefold_class) * stream->len);
+  memmove(stream->lbactions, stream->lbactions + n,
+	  sizeof(linefold_action) * stream->len);
+  if (stream->state.linestart < n)
+    stream->state.linestart = 0;
+  else
+    stream->state.linestart -= n;
+  stream->classified = (stream->classified < n)? 0: stream->classified - n;
+  stream->analyzed = (stream->analyzed < n)? 0: stream->analyzed - n;
+  memset(&stream->excess.fit, 0, sizeof(struct linefold_fit));
+}
+
+/*
+ * Work on characters buffered in stream by threads: Get their
+ * properties, then break lines of complete paragraphs.  A paragraph too
+ * long to wait for its end is broken as usual, and so is the rest of it.
+ * Whole text is written out if eot is true.
+ */
+static void
+stream_batch(struct linefold_stream *stream, int eot)
+{
+  struct linefold_info *lbinfo = &stream->lbinfo;
+  struct parallel_work work;
+  size_t end;
+
+  lbinfo->widths = stream->widths;
+  lbinfo->lbclasses = stream->lbclasses;
+  lbinfo->lbactions = stream->lbactions;
+  lbinfo->length = stream->len;
+  parallel_init(&work, lbinfo, stream->text, stream->nthreads);
+  work.lbprop_func = stream->lbprop_func;
+  work.tailor_lbprop = stream->tailor_lbprop;
+  work.excess = stream->excess;
+  work.writeout_cb = stream->writeout_cb;
+  work.maxlen = stream->maxlen;
+  work.voidarg = stream->voidarg;
+
+  if (stream->classified < stream->len) {
+    if (parallel_split(&work, stream->classified, stream->len, NULL))
+      parallel_run(&work, &getprop_worker, &getprop_worker);
+    else
+      getprop_text(stream->lbprop_func, stream->tailor_lbprop,
+		   stream->text + stream->classified,
+		   stream->len - stream->classified,
+		   stream->widths + stream->classified,
+		   stream->lbclasses + stream->classified,
+		   lbinfo->flags);
+    stream->classified = stream->len;
+  }
+
+  while (stream->len) {
+    lbinfo->length = stream->len;
+    if (stream->analyzed != 0) {
+      /* Finish the paragraph continued from earlier batches. */
+      if ((end = stream_paragraph_end(stream, stream->analyzed, eot, 0))
+	  == 0) {
+	stream_sequential(stream, &work, eot);
+	break;
+      }
+      find_linebreak_parallel(&work, &stream->state, stream->analyzed, end);
+      stream->lbactions[end-1] = (end == stream->len)?
+	LINEFOLD_ACTION_EOT: LINEFOLD_ACTION_EXPLICIT;
+      linebreak_init(&stream->state);
+      stream->analyzed = end;
+      stream_fold(stream, end, 1);
+    } else if ((end = stream_paragraph_end(stream, 0, eot, 1)) != 0) {
+      /* Complete paragraphs. */
+      find_linebreak_parallel(&work, &stream->state, 0, end);
+      stream->lbactions[end-1] = (end == stream->len)?
+	LINEFOLD_ACTION_EOT: LINEFOLD_ACTION_EXPLICIT;
+      linebreak_init(&stream->state);
+      lbinfo->length = end;
+      work.info = *lbinfo;
+      if (parallel_split(&work, 0, end, &is_explicit_break)) {
+	work.global_action = stream->global_action;
+	parallel_run(&work, &fold_worker, &emit_pieces);
+	stream->global_action = work.global_action;
+	stream_discard(stream, end);
+      } else
+	stream_fold(stream, end, 1);
+    } else {
+      /* Paragraph whose end isn't buffered. */
+      if (STREAM_BATCH * (size_t)stream->nthreads <= stream->len)
+	stream_sequential(stream, &work, 0);
+      break;
+    }
+  }
+  parallel_destroy(&work);
+}
+
+/* Find actions of characters in stream not analyzed yet by threads of
+   work, and break lines as usual. */
+static void
+stream_sequential(struct linefold_stream *stream, struct parallel_work *work,
+		  int eot)
+{
+  find_linebreak_parallel(work, &stream->state, stream->analyzed,
+			  stream->len);
+  stream->analyzed = stream->len;
+  if (eot) {
+    stream->lbactions[stream->len-1] = LINEFOLD_ACTION_EOT;
+    stream_fold(stream, stream->len, 1);
+  } else
+    stream_fold(stream, (2 < stream->len)? stream->len - 2: 0, 0);
+}
+
+/*
+ * Find the end of the first paragraph ending after from in stream, or of
+ * the last one if last is true.  End of text is also end of a paragraph
+ * if eot is true.  Returns offset after it, or 0 if none.
+ */
+static size_t
+stream_paragraph_end(struct linefold_stream *stream, size_t from, int eot,
+		     int last)
+{
+  size_t i;
+
+  /* Whether the last character ends a paragraph isn't fixed. */
+  if (last) {
+    if (eot)
+      return stream->len;
+    for (i = stream->len - 1; from < i; i--)
+      if (is_paragraph_end(&stream->lbinfo, i - 1))
+	return i;
+  } else {
+    /* Action of the character before from may not be fixed. */
+    for (i = from? from - 1: 0; i + 1 < stream->len; i++)
+      if (is_paragraph_end(&stream->lbinfo, i))
+	return i + 1;
+    if (eot)
+      return stream->len;
+  }
+  return 0;
+}
+
+/* Grow buffers of stream to hold len more characters. */
+static int
+stream_reserve(struct linefold_stream *stream, size_t len)
+{
+  size_t size = stream->size;
+  void *p;
+
+  if (stream->len + len <= size)
+    return 1;
+  if (size == 0)
+    size = STREAM_CHUNK;
+  while (size < stream->len + len)
+    size *= 2;
+
+  if ((p = realloc(stream->text, sizeof(linefold_char) * size)) == NULL)
+    return 0;
+  stream->text = p;
+  if ((p = realloc(stream->widths, sizeof(linefold_width) * size)) == NULL)
+    return 0;
+  stream->widths = p;
+  if ((p = realloc(stream->lbclasses, sizeof(linefold_class) * size))
+      == NULL)
+    return 0;
+  stream->lbclasses = p;
+  if ((p = realloc(stream->lbactions, sizeof(linefold_action) * size))
+      == NULL)
+    return 0;
+  stream->lbactions = p;
+  stream->size = size;
+  return 1;
+}
+
+/* Find the end of a line starting at linestart.  Returns offset of the
+   last character in the line, and sets line breaking action. */
+static size_t
+fit_line(const struct linefold_info *lbinfo, const linefold_char *text,
+	 size_t linestart, struct fold_excess *excess,
+	 size_t maxlen, void *voidarg, linefold_action *actionp)
+{
+  size_t textlen = lbinfo->length;
+  linefold_flags flags = lbinfo->flags;
+  linefold_action action = LINEFOLD_ACTION_NOMOD, prevaction;
+  size_t i, len, prevopp, fitend = linestart;
+
+  /* Fragments narrower than the limit never exceed by built-in measure:
+     Find them at once by width index. */
+  if (lbinfo->widthsums != NULL &&
+      excess->is_line_excess_incr == &linefold_is_line_excess_incr)
+    fitend += linefold_span_fit(lbinfo, linestart,
+				(maxlen < LINEFOLD_HARD_LIMIT)?
+				maxlen: LINEFOLD_HARD_LIMIT - 1);
+
+  prevaction = LINEFOLD_ACTION_PROHIBITED;
+  prevopp = linestart;
+  for (i = linestart; i < textlen; i++) {
+    action = LINEFOLD_LBACTION(lbinfo, i);
+    if (action == LINEFOLD_ACTION_COMBINING_INDIRECT)
+      action = LINEFOLD_ACTION_INDIRECT;
+
+    if (action == LINEFOLD_ACTION_PROHIBITED ||
+	action == LINEFOLD_ACTION_COMBINING_PROHIBITED ||
+	((flags & LINEFOLD_OPTION_NOBREAK_DIRECT) &&
+	 action == LINEFOLD_ACTION_DIRECT)) {
+      /* Prohibited break or ommited Direct break.
+	 Unbreakable fragment which has exceeded the limit will be
+	 forced to break regardless of the next oppotunity: Test it at
+	 doubled lengths, not to scan long run for every line. */
+      len = i-linestart+1;
+      if (prevaction != LINEFOLD_ACTION_PROHIBITED || fitend > i ||
+	  (len & (len-1)) != 0 ||
+	  !(flags & LINEFOLD_OPTION_FORCE_LINEWIDTH ||
+	    len > LINEFOLD_HARD_LIMIT) ||
+	  !line_excess(lbinfo, text, excess, linestart, len,
+		       maxlen, voidarg))
+	continue;
+      if (flags & LINEFOLD_OPTION_FORCE_LINEWIDTH)
+	i = force_fit(lbinfo, text, excess, linestart, i, maxlen, voidarg);
+      else
+	i = linestart + LINEFOLD_HARD_LIMIT - 1;
+      action = LINEFOLD_ACTION_DIRECT;
+      break;
+    } else if (fitend <= i &&
+	     line_excess(lbinfo, text, excess, linestart, i-linestart+1,
+			 maxlen, voidarg)) {
+      /* Line has exceeded the limit. Search previous line breaking
+	 oppotunity. */
+      if (prevaction != LINEFOLD_ACTION_PROHIBITED) {
+	/* Previous oppotunity was found. */
+	i = prevopp;
+	action = prevaction;
+      } else if (flags & LINEFOLD_OPTION_FORCE_LINEWIDTH &&
+		 i > linestart) {
+	/* If FORCE_LINEWIDTH option was set on, force maxlen,
+	   avoiding break before combining marks. */
+	i = force_fit(lbinfo, text, excess, linestart, i, maxlen, voidarg);
+	action = LINEFOLD_ACTION_DIRECT;
+      } else if (i-linestart+1 > LINEFOLD_HARD_LIMIT) {
+	/* Try forcing hard limit. */
+	i = linestart + LINEFOLD_HARD_LIMIT - 1;
+	action = LINEFOLD_ACTION_DIRECT;
+      }
+      break;
+    } else if (action == LINEFOLD_ACTION_EXPLICIT ||
+	       action == LINEFOLD_ACTION_EOT) {
+      /* Explicit break or End of Text. */
+      break;
+    } else {
+      /* Save line breaking oppotunity. */
+      prevopp = i;
+      prevaction = action;
+    }
+  }
+
+  *actionp = action;
+  return i;
+}
+
+/*
+ * Find the end of a line to be forced at the limit, when the fragment
+ * from linestart to exceeded has no break opportunities.  Returns offset
+ * of the last character in the line.  Fragments are assumed to exceed
+ * the limit no sooner than their longer ones.
+ */
+static size_t
+force_fit(const struct linefold_info *lbinfo, const linefold_char *text,
+	  struct fold_excess *excess, size_t linestart, size_t exceeded,
+	  size_t maxlen, void *voidarg)
+{
+  size_t lo, hi, mid;
+
+  /* Longest fitting fragment shorter than exceeded one, by bisection:
+     lo characters fit, hi characters don't (or exceed hard limit). */
+  lo = 0;
+  hi = exceeded - linestart + 1;
+  if (LINEFOLD_HARD_LIMIT < hi)
+    hi = LINEFOLD_HARD_LIMIT + 1;
+  while (lo + 1 < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (line_excess(lbinfo, text, excess, linestart, mid, maxlen, voidarg))
+      hi = mid;
+    else
+      lo = mid;
+  }
+
+  /* Avoid break before combining marks. */
+  while (0 < lo && LINEFOLD_LBACTION(lbinfo, linestart + lo - 1) ==
+	 LINEFOLD_ACTION_COMBINING_PROHIBITED)
+    lo--;
+  /* Not even the first character fits: break after it and its
+     combining marks. */
+  if (lo == 0) {
+    lo = 1;
+    while (linestart + lo < lbinfo->length &&
+	   LINEFOLD_LBACTION(lbinfo, linestart + lo - 1) ==
+	   LINEFOLD_ACTION_COMBINING_PROHIBITED)
+      lo++;
+  }
+  return linestart + lo - 1;
+}
+
+/* Call either of functions to determine excess of line. */
+static int
+line_excess(const struct linefold_info *lbinfo, const linefold_char *text,
+	    struct fold_excess *excess, size_t start, size_t len,
+	    size_t maxlen, void *voidarg)
+{
+  if (excess->is_line_excess_incr)
+    return (*excess->is_line_excess_incr)(lbinfo, text, &excess->fit,
+					  start, len, maxlen, voidarg);
+  if (excess->is_line_excess)
+    return (*excess->is_line_excess)(lbinfo, text, start, len, maxlen,
+				     voidarg);
+  else {
+    size_t start8, end8;
+
+    start8 = (start == excess->line)? excess->line8:
+      utf8_offset(lbinfo, excess, start);
+    end8 = utf8_offset(lbinfo, excess, start + len);
+    return (*excess->is_line_excess_utf8)(lbinfo, excess->text8, start8,
+					  end8 - start8, maxlen, voidarg);
+  }
+}
+
+/* Byte offset of i-th character of UTF-8 text, walking from the one
+   converted last if it is near before. */
+static size_t
+utf8_offset(const struct linefold_info *lbinfo, struct fold_excess *excess,
+	    size_t i)
+{
+  if (i < excess->pos || excess->pos + LINEFOLD_UTF8_STRIDE <= i)
+    excess->pos8 = linefold_utf8_offset(lbinfo, excess->text8, i);
+  else
+    excess->pos8 = utf8_skip(lbinfo, excess->text8, excess->pos8,
+			     i - excess->pos);
+  excess->pos = i;
+  return excess->pos8;
+}
+
+/* Whether i-th character is Hangul jamo combined with preceding ones in
+   the line starting at start. */
+static int
+is_combined_jamo(const struct linefold_info *lbinfo, size_t start, size_t i)
+{
+  linefold_class lbc = LINEFOLD_LBCLASS(lbinfo, i);
+
+  if (lbinfo->flags & LINEFOLD_OPTION_NOCOMBINE_HANGUL_JAMO)
+    return 0;
+  if (lbc == LINEFOLD_CLASS_JV)
+    return (i >= start+1 &&
+	    LINEFOLD_LBCLASS(lbinfo, i-1) == LINEFOLD_CLASS_JL);
+  if (lbc == LINEFOLD_CLASS_JT)
+    return (i >= start+2 &&
+	    LINEFOLD_LBCLASS(lbinfo, i-2) == LINEFOLD_CLASS_JL &&
+	    LINEFOLD_LBCLASS(lbinfo, i-1) == LINEFOLD_CLASS_JV);
+  return 0;
+}
+
+/* Width of characters from start to end, including trailing spaces. */
+static size_t
+span_real_width(const struct linefold_info *lbinfo, size_t start, size_t end)
+{
+  size_t i, width = 0;
+
+  if (lbinfo->widthsums != NULL) {
+    width = lbinfo->widthsums[end] - lbinfo->widthsums[start];
+    /* Jamo at the head may combine with characters before start. */
+    for (i = start; i < end && i < start+2; i++)
+      if (i != start+1 || LINEFOLD_LBCLASS(lbinfo, i) == LINEFOLD_CLASS_JT)
+	if (is_combined_jamo(lbinfo, 0, i))
+	  width += LINEFOLD_WIDTH(lbinfo, i);
+    return width;
+  }
+  for (i = start; i < end; i++)
+    if (!is_combined_jamo(lbinfo, start, i))
+      width += LINEFOLD_WIDTH(lbinfo, i);
+  return width;
+}
+
+/* Build width index: widthsums[i] is width of characters before i. */
+static int
+build_widthsums(struct linefold_info *lbinfo)
+{
+  size_t *widthsums, i;
+
+  if ((widthsums = malloc(sizeof(size_t) * (lbinfo->length + 1))) == NULL)
+    return 0;
+  widthsums[0] = 0;
+  for (i = 0; i < lbinfo->length; i++)
+    widthsums[i+1] = widthsums[i] +
+      (is_combined_jamo(lbinfo, 0, i)? 0: LINEFOLD_WIDTH(lbinfo, i));
+  lbinfo->widthsums = widthsums;
+  return 1;
+}
+
+/* Prepare work on text of lbinfo by nthreads threads. */
+static void
+parallel_init(struct parallel_work *work, struct linefold_info *lbinfo,
+	      const linefold_char *text, int nthreads)
+{
+  memset(work, 0, sizeof(struct parallel_work));
+  work->lbinfo = lbinfo;
+  work->info = *lbinfo;
+  work->text = text;
+  work->global_action = LINEFOLD_ACTION_NOMOD;
+  linebreak_init(&work->state);
+  if (nthreads < 1)
+    nthreads = default_jobs;
+  if (PARALLEL_MAXTHREADS < nthreads)
+    nthreads = PARALLEL_MAXTHREADS;
+#if USE_PTHREAD
+  if (1 < nthreads) {
+    if (pthread_mutex_init(&work->mutex, NULL) != 0)
+      nthreads = 1;
+    else if (pthread_cond_init(&work->cond, NULL) != 0) {
+      pthread_mutex_destroy(&work->mutex);
+      nthreads = 1;
+    }
+  }
+#else /* USE_PTHREAD */
+  nthreads = 1;
+#endif /* USE_PTHREAD */
+  work->nthreads = nthreads;
+}
+
+static void
+parallel_destroy(struct parallel_work *work)
+{
+  size_t i;
+
+  if (work->pieces != NULL)
+    for (i=0; i < work->npieces; i++)
+      free(work->pieces[i].lines);
+  free(work->pieces);
+#if USE_PTHREAD
+  if (1 < work->nthreads) {
+    pthread_cond_destroy(&work->cond);
+    pthread_mutex_destroy(&work->mutex);
+  }
+#endif /* USE_PTHREAD */
+}
+
+/*
+ * Split characters from first to last (exclusive) into pieces of about
+ * PARALLEL_CHUNK characters, and deal them to threads.  If is_end is not
+ * NULL, pieces end at characters it is true for.  Returns 0 if memory is
+ * exhausted.
+ */
+static int
+parallel_split(struct parallel_work *work, size_t first, size_t last,
+	       int (*is_end)(const struct linefold_info *, size_t))
+{
+  const struct linefold_info *lbinfo = work->lbinfo;
+  struct parallel_piece *pieces;
+  size_t start, end, n = 0;
+  int k;
+
+  /* Pieces but the last are not shorter than PARALLEL_CHUNK. */
+  free(work->pieces);
+  work->pieces = NULL;
+  work->npieces = 0;
+  if ((pieces = malloc(sizeof(struct parallel_piece) *
+		       ((last - first) / PARALLEL_CHUNK + 1))) == NULL)
+    return 0;
+
+  for (start = first; start < last; start = end) {
+    if (last - start <= PARALLEL_CHUNK)
+      end = last;
+    else {
+      end = start + PARALLEL_CHUNK;
+      if (is_end != NULL)
+	while (end < last && !(*is_end)(lbinfo, end - 1))
+	  end++;
+    }
+    pieces[n].start = start;
+    pieces[n].end = end;
+    pieces[n].state = PIECE_WAITING;
+    pieces[n].lines = NULL;
+    pieces[n].nlines = 0;
+    n++;
+  }
+  work->pieces = pieces;
+  work->npieces = n;
+  for (k = 0; k < work->nthreads; k++) {
+    work->deques[k].head = n * k / work->nthreads;
+    work->deques[k].tail = n * (k + 1) / work->nthreads;
+  }
+  return 1;
+}
+
+/*
+ * Call main_func by the caller while other threads call worker, and
+ * wait for all of them.  The caller works on the first deque.  Threads
+ * are taken from the pool, and those started anew are left in it after
+ * work.  Pieces of threads which couldn't be got are stolen by others.
+ */
+static void
+parallel_run(struct parallel_work *work, void *(*worker)(void *),
+	     void *(*main_func)(void *))
+{
+  struct parallel_thread threads[PARALLEL_MAXTHREADS];
+#if USE_PTHREAD
+  struct parallel_pooled *pooled;
+  int i, n = 0, pending = 0;
+
+  if (1 < work->nthreads && 1 < work->npieces) {
+    pthread_mutex_lock(&pool_mutex);
+    for (i = 1; i < work->nthreads && (size_t)i < work->npieces; i++) {
+      if ((pooled = pool_idle) != NULL)
+	pool_idle = pooled->next;
+      else if (pool_threads < PARALLEL_MAXTHREADS &&
+	       (pooled = malloc(sizeof(struct parallel_pooled))) != NULL) {
+	pooled->worker = NULL;
+	if (pthread_cond_init(&pooled->cond, NULL) != 0) {
+	  free(pooled);
+	  pooled = NULL;
+	} else if (pthread_create(&pooled->tid, NULL, pool_main,
+				  pooled) != 0) {
+	  pthread_cond_destroy(&pooled->cond);
+	  free(pooled);
+	  pooled = NULL;
+	} else {
+	  pthread_detach(pooled->tid);
+	  pool_threads++;
+	}
+      }
+      if (pooled == NULL)
+	break;
+      threads[i].work = work;
+      threads[i].self = i;
+      pooled->worker = worker;
+      pooled->arg = threads + i;
+      pooled->pending = &pending;
+      pending++;
+      n++;
+      pthread_cond_signal(&pooled->cond);
+    }
+    pthread_mutex_unlock(&pool_mutex);
+  }
+#endif /* USE_PTHREAD */
+  threads[0].work = work;
+  threads[0].self = 0;
+  (*main_func)(threads);
+#if USE_PTHREAD
+  if (n) {
+    pthread_mutex_lock(&pool_mutex);
+    while (pending)
+      pthread_cond_wait(&pool_done, &pool_mutex);
+    pthread_mutex_unlock(&pool_mutex);
+  }
+#endif /* USE_PTHREAD */
+}
+
+#if USE_PTHREAD
+/* Thread in the pool: do work given by parallel_run(), then wait for
+   next one.  It lasts until the process exits. */
+static void *
+pool_main(void *arg)
+{
+  struct parallel_pooled *pooled = arg;
+  void *(*worker)(void *);
+
+  pthread_mutex_lock(&pool_mutex);
+  for (;;) {
+    while ((worker = pooled->worker) == NULL)
+      pthread_cond_wait(&pooled->cond, &pool_mutex);
+    pthread_mutex_unlock(&pool_mutex);
+    (*worker)(pooled->arg);
+    pthread_mutex_lock(&pool_mutex);
+    pooled->worker = NULL;
+    if (--*pooled->pending == 0)
+      pthread_cond_broadcast(&pool_done);
+    pooled->next = pool_idle;
+    pool_idle = pooled;
+  }
+  /* NOTREACHED */
+  return NULL;
+}
+#endif /* USE_PTHREAD */
+
+/*
+ * Take a piece nobody has taken from the head of own deque, or if it is
+ * empty, from the tail of the deque having the most.  Returns NULL if
+ * none is left.
+ */
+static struct parallel_piece *
+parallel_take(struct parallel_work *work, int self)
+{
+  struct parallel_piece *pieces = work->pieces, *piece = NULL;
+  struct parallel_deque *deque, *victim = NULL;
+  int k;
+
+#if USE_PTHREAD
+  if (1 < work->nthreads)
+    pthread_mutex_lock(&work->mutex);
+#endif /* USE_PTHREAD */
+  /* Pieces in deques may have been taken out of turn by emit_pieces(). */
+  deque = work->deques + self;
+  while (deque->head < deque->tail &&
+	 pieces[deque->head].state != PIECE_WAITING)
+    deque->head++;
+  if (deque->head < deque->tail)
+    piece = pieces + deque->head++;
+  else {
+    for (k = 0; k < work->nthreads; k++) {
+      deque = work->deques + k;
+      while (deque->head < deque->tail &&
+	     pieces[deque->tail - 1].state != PIECE_WAITING)
+	deque->tail--;
+      if (deque->head < deque->tail &&
+	  (victim == NULL ||
+	   victim->tail - victim->head < deque->tail - deque->head))
+	victim = deque;
+    }
+    if (victim != NULL)
+      piece = pieces + --victim->tail;
+  }
+  if (piece != NULL)
+    piece->state = PIECE_RUNNING;
+#if USE_PTHREAD
+  if (1 < work->nthreads)
+    pthread_mutex_unlock(&work->mutex);
+#endif /* USE_PTHREAD */
+  return piece;
+}
+
+/* Tell that piece was finished (ok is true) or failed. */
+static void
+parallel_finish(struct parallel_work *work, struct parallel_piece *piece,
+		int ok)
+{
+#if USE_PTHREAD
+  if (1 < work->nthreads)
+    pthread_mutex_lock(&work->mutex);
+#endif /* USE_PTHREAD */
+  piece->state = ok? PIECE_DONE: PIECE_FAILED;
+#if USE_PTHREAD
+  if (1 < work->nthreads) {
+    pthread_cond_broadcast(&work->cond);
+    pthread_mutex_unlock(&work->mutex);
+  }
+#endif /* USE_PTHREAD */
+}
+
+/* Whether i-th character ends a paragraph.  Same as explicit breaks
+   find_linebreak_range() finds. */
+static int
+is_paragraph_end(const struct linefold_info *lbinfo, size_t i)
+{
+  linefold_class lbc = LINEFOLD_LBCLASS(lbinfo, i);
+
+  if (lbc == LINEFOLD_CLASS_BK || lbc == LINEFOLD_CLASS_LF ||
+      lbc == LINEFOLD_CLASS_NL)
+    return 1;
+  return (lbc == LINEFOLD_CLASS_CR &&
+	  (lbinfo->length <= i+1 ||
+	   LINEFOLD_LBCLASS(lbinfo, i+1) != LINEFOLD_CLASS_LF));
+}
+
+/* Whether line is broken explicitly after i-th character. */
+static int
+is_explicit_break(const struct linefold_info *lbinfo, size_t i)
+{
+  return (LINEFOLD_LBACTION(lbinfo, i) == LINEFOLD_ACTION_EXPLICIT);
+}
+
+/* Get properties of pieces. */
+static void *
+getprop_worker(void *arg)
+{
+  struct parallel_thread *thread = arg;
+  struct parallel_work *work = thread->work;
+  struct linefold_info *lbinfo = work->lbinfo;
+  struct parallel_piece *piece;
+  size_t start, len;
+  int ok;
+
+  while ((piece = parallel_take(work, thread->self)) != NULL) {
+    start = piece->start;
+    len = piece->end - piece->start;
+    ok = 1;
+    if (lbinfo->widths8 != NULL)
+      ok = getprop_compact(work->lbprop_func, work->tailor_lbprop,
+			   work->text + start, len,
+			   (signed char *)lbinfo->widths8 + start,
+			   (unsigned char *)lbinfo->lbclasses8 + start,
+			   lbinfo->flags);
+    else
+      getprop_text(work->lbprop_func, work->tailor_lbprop,
+		   work->text + start, len,
+		   (linefold_width *)lbinfo->widths + start,
+		   (linefold_class *)lbinfo->lbclasses + start,
+		   lbinfo->flags);
+    parallel_finish(work, piece, ok);
+  }
+  return NULL;
+}
+
+/*
+ * Find line breaking actions of pieces.  The first piece continues state
+ * of work.  Others start from a guess as if they started text; states
+ * after characters at their heads are kept for repair_piece().
+ */
+static void *
+linebreak_worker(void *arg)
+{
+  struct parallel_thread *thread = arg;
+  struct parallel_work *work = thread->work;
+  struct parallel_piece *piece;
+  struct linebreak_state *guesses;
+  size_t i, n;
+
+  while ((piece = parallel_take(work, thread->self)) != NULL) {
+    if (piece == work->pieces) {
+      piece->guess = work->state;
+      find_linebreak_info(work->lbinfo, &piece->guess,
+			  piece->start, piece->end, 0);
+    } else {
+      guesses = work->guesses + SPECULATE_WINDOW * (piece - work->pieces);
+      n = piece->end - piece->start;
+      if (SPECULATE_WINDOW < n)
+	n = SPECULATE_WINDOW;
+      linebreak_init(&piece->guess);
+      for (i = 0; i < n; i++) {
+	find_linebreak_info(work->lbinfo, &piece->guess, piece->start + i,
+			    piece->start + i + 1, piece->start);
+	guesses[i] = piece->guess;
+      }
+      find_linebreak_info(work->lbinfo, &piece->guess, piece->start + n,
+			  piece->end, piece->start);
+    }
+    parallel_finish(work, piece, 1);
+  }
+  return NULL;
+}
+
+/*
+ * Find line breaking actions of characters from start to end (exclusive)
+ * continuing state, as find_linebreak_info() does, sharing work among
+ * threads: Pieces of any length are analyzed at once, each but the first
+ * from a guessed state, and then repaired in order.
+ */
+static void
+find_linebreak_parallel(struct parallel_work *work,
+			struct linebreak_state *state, size_t start, size_t end)
+{
+  size_t i;
+
+  if (end <= start)
+    return;
+  if (work->nthreads < 2 || !parallel_split(work, start, end, NULL) ||
+      work->npieces < 2 ||
+      (work->guesses = malloc(sizeof(struct linebreak_state) *
+			      SPECULATE_WINDOW * work->npieces)) == NULL) {
+    find_linebreak_info(work->lbinfo, state, start, end, 0);
+    return;
+  }
+
+  work->state = *state;
+  parallel_run(work, &linebreak_worker, &linebreak_worker);
+  *state = work->pieces[0].guess;
+  for (i = 1; i < work->npieces; i++)
+    if (!repair_piece(work, state, work->pieces + i))
+      find_linebreak_info(work->lbinfo, state, work->pieces[i].start,
+			  work->pieces[i].end, 0);
+  free(work->guesses);
+  work->guesses = NULL;
+}
+
+/*
+ * Correct actions of piece found from a guessed state, now that the
+ * actual state before it is known: Characters at its head are analyzed
+ * again until both states agree, then state is set to the one after the
+ * piece.  Returns 0, touching nothing, if they don't agree within
+ * SPECULATE_WINDOW characters.
+ */
+static int
+repair_piece(struct parallel_work *work, struct linebreak_state *state,
+	     struct parallel_piece *piece)
+{
+  struct linefold_info *lbinfo = work->lbinfo;
+  const struct linebreak_state *guesses =
+    work->guesses + SPECULATE_WINDOW * (piece - work->pieces);
+  linefold_class lbclasses[SPECULATE_WINDOW + 3];
+  linefold_action lbactions[SPECULATE_WINDOW + 3];
+  struct linebreak_state actual = *state, next;
+  size_t base, end, i, j;
+
+  /* Work on copies of the head and two characters before it: writing
+     back in order of characters would undo modifications made by later
+     ones while guessing. */
+  base = (piece->start < 2)? 0: piece->start - 2;
+  end = piece->start + SPECULATE_WINDOW + 1;
+  if (piece->end < end)
+    end = piece->end;
+  for (j=base; j < end; j++) {
+    lbclasses[j-base] = LINEFOLD_LBCLASS(lbinfo, j);
+    lbactions[j-base] = LINEFOLD_LBACTION(lbinfo, j);
+  }
+
+  for (i=piece->start; i < end && i < piece->start + SPECULATE_WINDOW; i++) {
+    find_linebreak_range(&actual, lbclasses, lbactions, base, i, i+1,
+			 lbinfo->flags);
+    if (!linebreak_agree(&actual, guesses + (i - piece->start), i+1))
+      continue;
+
+    /* Actions from i-th character on are the same as guessed, but the
+       next character may modify action of (i-1)-th. */
+    if (i+1 < end) {
+      next = actual;
+      find_linebreak_range(&next, lbclasses, lbactions, base, i+1, i+2,
+			   lbinfo->flags);
+    }
+    for (j=base; j < i; j++)
+      if (lbinfo->lbactions8 != NULL)
+	((unsigned char *)lbinfo->lbactions8)[j] =
+	  (unsigned char)lbactions[j-base];
+      else
+	((linefold_action *)lbinfo->lbactions)[j] = lbactions[j-base];
+    *state = piece->guess;
+    return 1;
+  }
+  return 0;
+}
+
+/* Fit lines of paragraphs, and keep them. */
+static void *
+fold_worker(void *arg)
+{
+  struct parallel_thread *thread = arg;
+  struct parallel_work *work = thread->work;
+  struct parallel_piece *piece;
+
+  while ((piece = parallel_take(work, thread->self)) != NULL)
+    parallel_finish(work, piece, fit_piece(work, piece));
+  return NULL;
+}
+
+/*
+ * Write out lines of pieces in order, waiting for other threads to fit
+ * them.  A piece nobody has taken is fitted here, and so is a piece
+ * whose lines couldn't be kept.
+ */
+static void *
+emit_pieces(void *arg)
+{
+  struct parallel_work *work = ((struct parallel_thread *)arg)->work;
+  struct linefold_info *lbinfo = work->lbinfo;
+  struct parallel_piece *piece;
+  struct fold_excess excess;
+  linefold_action action;
+  size_t i, j, start, end;
+  int state;
 
-  if (text == NULL || textlen == 0)
-    return NULL;
+  for (i=0; i < work->npieces; i++) {
+    piece = work->pieces + i;
+#if USE_PTHREAD
+    if (1 < work->nthreads)
+      pthread_mutex_lock(&work->mutex);
+#endif /* USE_PTHREAD */
+    if ((state = piece->state) == PIECE_WAITING)
+      piece->state = PIECE_RUNNING;
+#if USE_PTHREAD
+    else
+      while ((state = piece->state) == PIECE_RUNNING)
+	pthread_cond_wait(&work->cond, &work->mutex);
+    if (1 < work->nthreads)
+      pthread_mutex_unlock(&work->mutex);
+#endif /* USE_PTHREAD */
+    if (state == PIECE_WAITING)
+      state = fit_piece(work, piece)? PIECE_DONE: PIECE_FAILED;
 
-  if ((widths = malloc(sizeof(linefold_width) * textlen)) == NULL) {
-    return NULL;
-  }
-  if ((lbclasses = malloc(sizeof(linefold_class) * textlen)) == NULL) {
-    free(widths);
-    return NULL;
-  }
-  if ((lbactions = malloc(sizeof(linefold_action) * textlen)) == NULL) {
-    free(widths);
-    free(lbclasses);
-    return NULL;
-  }
-  if (chset && *chset) {
-    if ((charset = malloc(strlen(chset)+1)) == NULL) {
-      free(widths);
-      free(lbclasses);
-      free(lbactions);
-      return NULL;
-    } else {
-      memcpy(charset, chset, strlen(chset)+1);
+    start = piece->start;
+    if (state == PIECE_DONE)
+      for (j=0; j < piece->nlines; j++) {
+	end = piece->lines[j].end;
+	emit_line(lbinfo, work->text, start, end, piece->lines[j].action,
+		  work->writeout_cb, work->voidarg, &work->global_action);
+	start = end + 1;
+      }
+    else {
+      excess = work->excess;
+      memset(&excess.fit, 0, sizeof(struct linefold_fit));
+      while (start < piece->end) {
+	end = fit_line(lbinfo, work->text, start, &excess, work->maxlen,
+		       work->voidarg, &action);
+	emit_line(lbinfo, work->text, start, end, action,
+		  work->writeout_cb, work->voidarg, &work->global_action);
+	start = end + 1;
+      }
     }
+    free(piece->lines);
+    piece->lines = NULL;
   }
-  if ((lbinfo = malloc(sizeof(struct linefold_info))) == NULL) {
-    free(widths);
-    free(lbclasses);
-    free(lbactions);
-    if (charset) free(charset);
-    return NULL;
+  return NULL;
+}
+
+/* Fit lines of piece on a copy of line breaking informations.  Returns
+   0 if memory is exhausted. */
+static int
+fit_piece(struct parallel_work *work, struct parallel_piece *piece)
+{
+  struct linefold_info lbinfo = work->info;
+  struct fold_excess excess = work->excess;
+  struct parallel_line *lines;
+  linefold_action action;
+  size_t i, end, size = 0;
+
+  lbinfo.linp = lbinfo.lint = lbinfo.pint = 0;
+  memset(&excess.fit, 0, sizeof(struct linefold_fit));
+  for (i = piece->start; i < piece->end; i = end + 1) {
+    end = fit_line(&lbinfo, work->text, i, &excess, work->maxlen,
+		   work->voidarg, &action);
+    if (piece->nlines == size) {
+      size = size? size * 2: 64;
+      if ((lines = realloc(piece->lines,
+			   sizeof(struct parallel_line) * size)) == NULL) {
+	free(piece->lines);
+	piece->lines = NULL;
+	piece->nlines = 0;
+	return 0;
+      }
+      piece->lines = lines;
+    }
+    piece->lines[piece->nlines].end = end;
+    piece->lines[piece->nlines].action = action;
+    piece->nlines++;
+    next_line_index(&lbinfo, action);
   }
+  return 1;
+}
 
-  if (find_lbprop_func == NULL)
-    find_lbprop_func = &linefold_find_lbprop_func;
-  if (tailor_lbprop == NULL)
-    tailor_lbprop = &linefold_tailor_lbprop;
+/* Get tailored properties of characters. */
+static void
+getprop_text(linefold_lbprop_funcptr lbprop_func,
+	     void (*tailor_lbprop)(linefold_char,
+				   linefold_width *, linefold_class *,
+				   linefold_flags),
+	     const linefold_char *text, size_t textlen,
+	     linefold_width *widths, linefold_class *lbclasses,
+	     linefold_flags flags)
+{
+  size_t i;
+
+  /* Only built-in functions, that lookup tables are found for, are
+     cached. */
+  if (tailor_lbprop == &linefold_tailor_lbprop &&
+      linefold_find_lbprop_bulk_func(lbprop_func) != NULL) {
+    getprop_tailored(lbprop_func, text, textlen, widths, lbclasses, flags);
+    return;
+  }
 
-  lbprop_func = (*find_lbprop_func)(charset, flags);
+  /* Customized functions may depend on anything: call them for each
+     character. */
   for (i=0; i < textlen; i++) {
     (*lbprop_func)(text[i], widths+i, lbclasses+i);
     (*tailor_lbprop)(text[i], widths+i, lbclasses+i, flags);
-    lbactions[i] = LINEFOLD_ACTION_PROHIBITED;
-  }
-
-  if (find_linebreak(textlen, lbclasses, lbactions, flags) == 0) {
-    free(widths);
-    free(lbclasses);
-    free(lbactions);
-    if (charset) free(charset);
-    return NULL;
   }
-
-  lbinfo->widths = widths;
-  lbinfo->lbclasses = lbclasses;
-  lbinfo->lbactions = lbactions;
-  lbinfo->charset = charset;
-  lbinfo->length = textlen;
-  lbinfo->flags = flags;
-  lbinfo->linp = lbinfo->lint = lbinfo->pint = 0;
-  return lbinfo;
 }
 
-/* Free storage of line break informations. */
-void linefold_free(struct linefold_info *lbinfo)
+/* Get tailored properties of characters into bytes.  Returns 0 if any
+   property doesn't fit in a byte. */
+static int
+getprop_compact(linefold_lbprop_funcptr lbprop_func,
+		void (*tailor_lbprop)(linefold_char,
+				      linefold_width *, linefold_class *,
+				      linefold_flags),
+		const linefold_char *text, size_t textlen,
+		signed char *widths8, unsigned char *lbclasses8,
+		linefold_flags flags)
 {
-  if (lbinfo == NULL)
-    return;
+  linefold_width widths[COMPACT_CHUNK];
+  linefold_class lbclasses[COMPACT_CHUNK];
+  size_t i, j, len;
 
-  free((void *)lbinfo->widths);
-  free((void *)lbinfo->lbclasses);
-  free((void *)lbinfo->lbactions);
-  if (lbinfo->charset) free((void *)lbinfo->charset);
-  free(lbinfo);
+  for (i=0; i < textlen; i += len) {
+    len = textlen - i;
+    if (COMPACT_CHUNK < len)
+      len = COMPACT_CHUNK;
+    getprop_text(lbprop_func, tailor_lbprop, text+i, len,
+		 widths, lbclasses, flags);
+    for (j=0; j < len; j++) {
+      if (widths[j] < -128 || 127 < widths[j] ||
+	  lbclasses[j] < 0 || 255 < lbclasses[j])
+	return 0;
+      widths8[i+j] = (signed char)widths[j];
+      lbclasses8[i+j] = (unsigned char)lbclasses[j];
+    }
+  }
+  return 1;
 }
 
-/* Do line breaking */
-linefold_action
-linefold(struct linefold_info *lbinfo, linefold_char *text,
-	 int (*is_line_excess)(const struct linefold_info *,
-			       const linefold_char *,
-			       size_t, size_t, size_t, void *),
-	 void (*writeout_cb)(const struct linefold_info *,
-			     const linefold_char *,
-			     size_t, size_t, linefold_action, void *),
-	 size_t maxlen, void *voidarg)
+/* Get properties tailored by built-in linefold_tailor_lbprop(). */
+static void
+getprop_tailored(linefold_lbprop_funcptr lbprop_func,
+		 const linefold_char *text, size_t textlen,
+		 linefold_width *widths, linefold_class *lbclasses,
+		 linefold_flags flags)
 {
-  size_t textlen;
-  const linefold_action *lbactions;
-  linefold_flags flags;
-  linefold_action global_action=LINEFOLD_ACTION_NOMOD,
-    action, prevaction;
-  size_t i=0, linestart, prevopp;
-
-  if (lbinfo == NULL)
-    return LINEFOLD_ACTION_NOMOD;
-  textlen = lbinfo->length;
-  lbactions = lbinfo->lbactions;
-  flags = lbinfo->flags;
+  const struct linefold_propcache *cache;
+  linefold_width ascii_widths[ASCII_TABSIZE];
+  linefold_class ascii_classes[ASCII_TABSIZE];
+  unsigned long c;
+  unsigned char v;
+  size_t i, run;
 
-  if (is_line_excess == NULL)
-    is_line_excess = &linefold_is_line_excess;
+  if ((cache = linefold_propcache_get(lbprop_func, flags)) == NULL) {
+    linefold_getprop_bulk(lbprop_func, text, textlen, widths, lbclasses);
+    for (i=0; i < textlen; i++)
+      linefold_tailor_lbprop(text[i], widths+i, lbclasses+i, flags);
+    return;
+  }
 
-  while (i < textlen) {
-    prevaction = LINEFOLD_ACTION_PROHIBITED;
-    prevopp = linestart = i;
-    for ( ; i < textlen; i++) {
-      action = lbactions[i];
-      if (action == LINEFOLD_ACTION_COMBINING_INDIRECT)
-	action = LINEFOLD_ACTION_INDIRECT;
-
-      if (action == LINEFOLD_ACTION_PROHIBITED ||
-	  action == LINEFOLD_ACTION_COMBINING_PROHIBITED)
-	/* Prohibited break. */
-	continue;
-      else if ((flags & LINEFOLD_OPTION_NOBREAK_DIRECT) &&
-	       action == LINEFOLD_ACTION_DIRECT)
-	/* Ommited Direct break */
-	continue;
-      else if ((*is_line_excess)(lbinfo, text, linestart, i-linestart+1,
-				 maxlen, voidarg)) {
-	/* Line has exceeded the limit. Search previous line breaking
-	   oppotunity. */
-	if (prevaction != LINEFOLD_ACTION_PROHIBITED) {
-	  /* Previous oppotunity was found. */
-	  i = prevopp;
-	  action = prevaction;
-	} else if (flags & LINEFOLD_OPTION_FORCE_LINEWIDTH &&
-		   i > linestart) {
-	  /* If FORCE_LINEWIDTH option was set on, force maxlen,
-	     avoiding break before combining marks. */
-	  while (i >= linestart) {
-	    i--;
-	    if (lbactions[i] != LINEFOLD_ACTION_COMBINING_PROHIBITED &&
-		!(*is_line_excess)(lbinfo, text, linestart, i-linestart+1,
-				   maxlen, voidarg))
-	      break;
-	  }
-	  action = LINEFOLD_ACTION_DIRECT;
-	} else if (i-linestart+1 > LINEFOLD_HARD_LIMIT) {
-	  /* Try forcing hard limit. */
-	  i = linestart + LINEFOLD_HARD_LIMIT - 1;
-	  action = LINEFOLD_ACTION_DIRECT;
-	}
+  for (c=0; c < ASCII_TABSIZE; c++) {
+    v = PROPCACHE_VALUE(cache, c);
+    ascii_widths[c] = cache->widths[v];
+    ascii_classes[c] = cache->lbclasses[v];
+  }
 
-	/* Write out a broken line. */
-	if (writeout_cb != NULL)
-	  (*writeout_cb)(lbinfo, text, linestart, i-linestart+1, action,
-			 voidarg);
-	/* Save line breaking action. */
-	if (action == LINEFOLD_ACTION_DIRECT ||
-	    (action == LINEFOLD_ACTION_INDIRECT &&
-	     global_action != LINEFOLD_ACTION_DIRECT))
-	  global_action = action;
-
-	i++;
-	break;
-      } else if (action == LINEFOLD_ACTION_EXPLICIT ||
-		 action == LINEFOLD_ACTION_EOT) {
-	/* Explicit break or End of Text. */
-	if (writeout_cb != NULL)
-	  (*writeout_cb)(lbinfo, text, linestart, i-linestart+1, action,
-			 voidarg);
-
-        i++;
-        break;
-      } else {
-	/* Save line breaking oppotunity. */
-        prevopp = i;
-	prevaction = action;
+  for (i=0, run=0; i < textlen; i++) {
+    c = (unsigned long)text[i];
+    if (c < ASCII_TABSIZE) {
+      widths[i] = ascii_widths[c];
+      lbclasses[i] = ascii_classes[c];
+      /* Long runs of ASCII are passed to the kernel. */
+      if (++run == ASCII_MINRUN) {
+	i += linefold_ascii_props(text+i+1, textlen-i-1,
+				  ascii_widths, ascii_classes,
+				  widths+i+1, lbclasses+i+1);
+	run = 0;
       }
+      continue;
     }
-    /* update line indice */
-    if (action == LINEFOLD_ACTION_EXPLICIT ||
-	action == LINEFOLD_ACTION_EOT) {
-      lbinfo->linp = 0;
-      lbinfo->lint++;
-      lbinfo->pint++;
+
+    run = 0;
+    if (c < PROPCACHE_LIMIT) {
+      v = PROPCACHE_VALUE(cache, c);
+      widths[i] = cache->widths[v];
+      lbclasses[i] = cache->lbclasses[v];
     } else {
-      lbinfo->linp++;
-      lbinfo->lint++;
+      (*lbprop_func)(text[i], widths+i, lbclasses+i);
+      linefold_tailor_lbprop(text[i], widths+i, lbclasses+i, flags);
     }
   }
+}
 
-  return global_action;
+/*
+ * Decode UTF-8 text of len8 bytes into chunks and get tailored properties
+ * of them into arrays of lbinfo, recording byte offsets of characters.
+ * Returns 0 on failure.
+ */
+static int
+getprop_utf8(linefold_lbprop_funcptr lbprop_func,
+	     void (*tailor_lbprop)(linefold_char,
+				   linefold_width *, linefold_class *,
+				   linefold_flags),
+	     const char *text8, size_t len8, struct linefold_info *lbinfo)
+{
+  linefold_char text[COMPACT_CHUNK];
+  const unsigned char *p = (const unsigned char *)text8, *end = p + len8;
+  size_t textlen = lbinfo->length, *offsets, i, j, len;
+
+  if ((lbinfo->utf8offsets = offsets =
+       malloc(sizeof(size_t) * (textlen / LINEFOLD_UTF8_STRIDE + 2))) ==
+      NULL)
+    return 0;
+
+  for (i=0; i < textlen; i += len) {
+    len = textlen - i;
+    if (COMPACT_CHUNK < len)
+      len = COMPACT_CHUNK;
+    for (j=0; j < len; j++) {
+      if ((i+j) % LINEFOLD_UTF8_STRIDE == 0)
+	offsets[(i+j) / LINEFOLD_UTF8_STRIDE] =
+	  p - (const unsigned char *)text8;
+      if (*p < 0x80)
+	text[j] = (linefold_char)*(p++);
+      else
+	p += utf8_getc(p, end, text+j);
+    }
+    if (lbinfo->widths8 != NULL) {
+      if (getprop_compact(lbprop_func, tailor_lbprop, text, len,
+			  (signed char *)lbinfo->widths8 + i,
+			  (unsigned char *)lbinfo->lbclasses8 + i,
+			  lbinfo->flags) == 0)
+	return 0;
+    } else
+      getprop_text(lbprop_func, tailor_lbprop, text, len,
+		   (linefold_width *)lbinfo->widths + i,
+		   (linefold_class *)lbinfo->lbclasses + i, lbinfo->flags);
+  }
+  if (textlen % LINEFOLD_UTF8_STRIDE == 0)
+    offsets[textlen / LINEFOLD_UTF8_STRIDE] = len8;
+  offsets[textlen / LINEFOLD_UTF8_STRIDE + 1] = len8;
+  return 1;
 }
 
 /*
- * Private functions
+ * Decode a character of UTF-8 at p and returns its length in bytes.
+ * Malformed byte and too large character are decoded to U+FFFD.  cp may
+ * be NULL.
  */
+static size_t
+utf8_getc(const unsigned char *p, const unsigned char *end,
+	  linefold_char *cp)
+{
+  unsigned long c = *p;
+  unsigned char lo = 0x80, hi = 0xBF;
+  size_t i, len;
 
-/* Internal default of function to find function that get properties of
-   a character.  */
-linefold_lbprop_funcptr
-linefold_find_lbprop_func(const char *chset, linefold_flags flags)
+  if (c < 0x80) {
+    if (cp != NULL)
+      *cp = (linefold_char)c;
+    return 1;
+  }
+
+  /* Ranges of the second byte are restricted by RFC 3629. */
+  if (0xC2 <= c && c <= 0xDF) {
+    len = 2;
+    c &= 0x1F;
+  } else if (0xE0 <= c && c <= 0xEF) {
+    len = 3;
+    c &= 0x0F;
+    if (c == 0x00)
+      lo = 0xA0;
+    else if (c == 0x0D)
+      hi = 0x9F;
+  } else if (0xF0 <= c && c <= 0xF4) {
+    len = 4;
+    c &= 0x07;
+    if (c == 0x00)
+      lo = 0x90;
+    else if (c == 0x04)
+      hi = 0x8F;
+  } else
+    len = 0;
+  if (len == 0 || (size_t)(end - p) < len || p[1] < lo || hi < p[1]) {
+    if (cp != NULL)
+      *cp = (linefold_char)0xFFFD;
+    return 1;
+  }
+  for (i=1; i < len; i++) {
+    if (p[i] < 0x80 || 0xBF < p[i]) {
+      if (cp != NULL)
+	*cp = (linefold_char)0xFFFD;
+      return 1;
+    }
+    c = (c << 6) | (p[i] & 0x3F);
+  }
+  if (cp != NULL)
+    *cp = (linefold_char)((UTF8_MAXCHAR < c)? 0xFFFD: c);
+  return len;
+}
+
+/* Byte offset of n-th character after one at offset off of UTF-8 text. */
+static size_t
+utf8_skip(const struct linefold_info *lbinfo, const char *text, size_t off,
+	  size_t n)
 {
-  if (chset == NULL || flags & LINEFOLD_OPTION_GENERIC_WIDTH)
-    return &linefold_getprop_generic;
-  else if (charsetcmp(chset, "CNS")==0 || /* not a charset name. */
-	   charsetcmp(chset, "BIG5")==0 ||
-	   charsetcmp(chset, "BIG5-ETEN")==0 ||
-	   charsetcmp(chset, "BIG5-HKSCS")==0 ||
-	   charsetcmp(chset, "EUC-TW")==0 ||
-	   charsetcmp(chset, "CP950")==0)
-    return &linefold_getprop_C;
-  else if (charsetcmp(chset, "GB")==0 || /* not a charset name */
-	   charsetcmp(chset, "EUC-CN")==0 ||
-	   charsetcmp(chset, "ISO-2022-CN")==0 ||
-	   charsetcmp(chset, "ISO-2022-CN-EXT")==0 ||
-	   charsetcmp(chset, "HZ")==0 ||
-	   charsetcmp(chset, "HZ-GB-2312")==0 ||
-	   charsetcmp(chset, "GB2312")==0 ||
-	   charsetcmp(chset, "GBK")==0 ||
-	   charsetcmp(chset, "GB18030")==0 ||
-	   charsetcmp(chset, "CP936")==0)
-    return &linefold_getprop_G;
-  else if (charsetcmp(chset, "JIS")==0 || /* not a charset name */
-	   charsetcmp(chset, "ISO-2022-JP")==0 ||
-	   charsetcmp(chset, "ISO-2022-JP-1")==0 ||
-	   charsetcmp(chset, "ISO-2022-JP-2")==0 ||
-	   charsetcmp(chset, "ISO-2022-JP-3")==0 ||
-	   charsetcmp(chset, "ISO-2022-JP-3-PLANE1")==0 ||
-	   charsetcmp(chset, "ISO-2022-JP-2004")==0 ||
-	   charsetcmp(chset, "ISO-2022-JP-2004-PLANE1")==0 ||
-	   charsetcmp(chset, "EUC-JP")==0 ||
-	   charsetcmp(chset, "EUC-JISX0213")==0 ||
-	   charsetcmp(chset, "EUC-JISX0213-PLANE1")==0 ||
-	   charsetcmp(chset, "EUC-JIS-2004")==0 ||
-	   charsetcmp(chset, "EUC-JIS-2004-PLANE1")==0 ||
-	   charsetcmp(chset, "SHIFT_JIS")==0 ||
-	   charsetcmp(chset, "SHIFT_JISX0213")==0 ||
-	   charsetcmp(chset, "SHIFT_JISX0213-PLANE1")==0 ||
-	   charsetcmp(chset, "SHIFT_JIS-2004")==0 ||
-	   charsetcmp(chset, "SHIFT_JIS-2004-PLANE1")==0 ||
-	   charsetcmp(chset, "CP932")==0 ||
-	   charsetcmp(chset, "CP942")==0 || /* IBM */
-	   charsetcmp(chset, "CP943")==0) /* IBM */
-    return &linefold_getprop_J;
-  else if (charsetcmp(chset, "KS")==0 || /* not a charset name */
-	   charsetcmp(chset, "ISO-2022-KR")==0 ||
-	   charsetcmp(chset, "EUC-KR")==0 ||
-	   charsetcmp(chset, "CP949")==0 ||
-	   charsetcmp(chset, "UHC")==0 ||
-	   charsetcmp(chset, "KS_C_5601-1987")==0)
-    return &linefold_getprop_K;
-  else
-    return &linefold_getprop_generic;
+  const unsigned char *p = (const unsigned char *)text + off;
+  const unsigned char *end = (const unsigned char *)text +
+    lbinfo->utf8offsets[lbinfo->length / LINEFOLD_UTF8_STRIDE + 1];
+
+  for (; n > 0 && p < end; n--)
+    p += (*p < 0x80)? 1: utf8_getc(p, end, NULL);
+  return p - (const unsigned char *)text;
 }
 
 static int
@@ -428,135 +2646,267 @@ linefold_tailor_lbprop(linefold_char c,
   return;
 }
 
+/* Find line breaking actions of text. */
+static size_t
+find_linebreak(struct linefold_info *lbinfo)
+{
+  return find_linebreak_span(lbinfo, 0, lbinfo->length,
+			     LINEFOLD_ACTION_EOT);
+}
+
+/*
+ * Find line breaking actions of characters from start to end (exclusive)
+ * as if they were whole text.  Characters outside are not touched; start
+ * must follow an explicit break, and action of the last character is
+ * set to last.
+ */
 static size_t
-find_linebreak(size_t textlen,
-	       linefold_class *lbclasses, linefold_action *lbactions,
-	       linefold_flags flags)
+find_linebreak_span(struct linefold_info *lbinfo, size_t start, size_t end,
+		    linefold_action last)
+{
+  struct linebreak_state state;
+
+  if (end <= start)
+    return 0;
+
+  linebreak_init(&state);
+  find_linebreak_info(lbinfo, &state, start, end, start);
+  if (lbinfo->lbactions8 != NULL)
+    ((unsigned char *)lbinfo->lbactions8)[end-1] = (unsigned char)last;
+  else
+    ((linefold_action *)lbinfo->lbactions)[end-1] = last;
+  return end - start;
+}
+
+/*
+ * Find line breaking actions of characters of lbinfo from start to end
+ * (exclusive) continuing state, as find_linebreak_range() does, in either
+ * layout.  Actions of characters before lowest are not touched.
+ */
+static void
+find_linebreak_info(struct linefold_info *lbinfo,
+		    struct linebreak_state *state,
+		    size_t start, size_t end, size_t lowest)
+{
+  linefold_class lbclasses[COMPACT_CHUNK + 2];
+  linefold_action lbactions[COMPACT_CHUNK + 2];
+  size_t i, j, base, chunkend;
+
+  if (lbinfo->lbclasses8 == NULL) {
+    find_linebreak_range(state, (linefold_class *)lbinfo->lbclasses,
+			 (linefold_action *)lbinfo->lbactions,
+			 0, start, end, lbinfo->flags);
+    return;
+  }
+
+  /* Compact layout: Work on copies of a chunk and two characters
+     before it, which may be modified. */
+  for (i=start; i < end; i = chunkend) {
+    base = (i < lowest+2)? lowest: i - 2;
+    chunkend = end - i;
+    if (COMPACT_CHUNK < chunkend)
+      chunkend = COMPACT_CHUNK;
+    chunkend += i;
+    for (j=base; j < chunkend; j++) {
+      lbclasses[j-base] = (linefold_class)lbinfo->lbclasses8[j];
+      lbactions[j-base] = (linefold_action)lbinfo->lbactions8[j];
+    }
+    find_linebreak_range(state, lbclasses, lbactions, base, i, chunkend,
+			 lbinfo->flags);
+    for (j=base; j < chunkend; j++)
+      ((unsigned char *)lbinfo->lbactions8)[j] =
+	(unsigned char)lbactions[j-base];
+  }
+}
+
+/* Initialize state of find_linebreak_range(). */
+static void
+linebreak_init(struct linebreak_state *state)
+{
+  state->before = -1;
+  state->linestart = 0;
+}
+
+/*
+ * Whether states of find_linebreak_range() before i-th character give
+ * the same actions from it on.  Starts of lines both two characters or
+ * more before it make no difference.
+ */
+static int
+linebreak_agree(const struct linebreak_state *a,
+		const struct linebreak_state *b, size_t i)
+{
+  if (a->before != b->before)
+    return 0;
+  return (a->linestart == b->linestart ||
+	  (a->linestart + 2 <= i && b->linestart + 2 <= i));
+}
+
+/*
+ * Find line breaking actions of characters from start to end (exclusive).
+ * Arrays hold informations of characters from base, and actions of two
+ * characters before start may be modified.  State is updated so that
+ * next range may be continued.  Action of the last character is not
+ * fixed until next range has been found or end of text.
+ */
+static void
+find_linebreak_range(struct linebreak_state *state,
+		     const linefold_class *lbclasses,
+		     linefold_action *lbactions,
+		     size_t base, size_t start, size_t end,
+		     linefold_flags flags)
 {
-  linefold_class before; /* class of 'before' character */
+  linefold_class before = state->before; /* class of 'before' character */
   linefold_class after;
   linefold_action action;
-  size_t idx = 0;
-  size_t linestart;
+  size_t linestart = state->linestart;
+  size_t idx; /* index relative to base */
 
-  if (textlen == 0)
-    return 0;
+  for (idx = start - base; idx < end - base; idx++) {
+    after = lbclasses[idx];
 
-  while (idx < textlen) {
-    /* Loop on one line ending with Explicit Break or end of text. */
-    linestart = idx;
-    before = lbclasses[idx];
-    idx++;
-    for (; idx < textlen &&
-	   before != LINEFOLD_CLASS_BK &&
-	   before != LINEFOLD_CLASS_LF &&
-	   before != LINEFOLD_CLASS_NL &&
-	   (before != LINEFOLD_CLASS_CR ||
-	    lbclasses[idx] == LINEFOLD_CLASS_LF);
-	 idx++) {
-      after = lbclasses[idx];
-
-      /* Explicit Breaks */
-      if (after == LINEFOLD_CLASS_BK ||
-	  after == LINEFOLD_CLASS_LF ||
-	  after == LINEFOLD_CLASS_NL) {
-	/* BK, LF, NL */
-	lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
-	before = after;
-	continue;
-      } else if (after == LINEFOLD_CLASS_CR) {
-	/* CR */
-	lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
-	before = after;
-	continue;
-      }
-      /* Space */
-      else if (after == LINEFOLD_CLASS_SP) {
-	/* SP */
-	lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
-	/* do not update class of 'before' character */
-	continue;
-      }
-      /* In case line starts with Space(s) */
-      if (before == LINEFOLD_CLASS_SP) {
-	lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
-	before = after;
-	continue;
-      }
+    /* Start of text */
+    if (before < 0) {
+      linestart = base + idx;
+      before = after;
+      continue;
+    }
+    /* Always break at end of line. */
+    if (before == LINEFOLD_CLASS_BK ||
+	before == LINEFOLD_CLASS_LF ||
+	before == LINEFOLD_CLASS_NL ||
+	(before == LINEFOLD_CLASS_CR && after != LINEFOLD_CLASS_LF)) {
+      lbactions[idx-1] = LINEFOLD_ACTION_EXPLICIT;
+      linestart = base + idx;
+      before = after;
+      continue;
+    }
 
-      /* Lookup pair table */
-      assert(before < LINEFOLD_CLASS_TABLESIZE);
-      assert(after < LINEFOLD_CLASS_TABLESIZE);
-      action = linefold_lbpairs[before][after];
-      /* Save line breaking action */
-      lbactions[idx-1] = action;
+    /* Explicit Breaks */
+    if (after == LINEFOLD_CLASS_BK ||
+	after == LINEFOLD_CLASS_LF ||
+	after == LINEFOLD_CLASS_NL) {
+      /* BK, LF, NL */
+      lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
+      before = after;
+      continue;
+    } else if (after == LINEFOLD_CLASS_CR) {
+      /* CR */
+      lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
+      before = after;
+      continue;
+    }
+    /* Space */
+    else if (after == LINEFOLD_CLASS_SP) {
+      /* SP */
+      lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
+      /* do not update class of 'before' character */
+      continue;
+    }
+    /* In case line starts with Space(s) */
+    if (before == LINEFOLD_CLASS_SP) {
+      lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
+      before = after;
+      continue;
+    }
 
-      /* Direct Break */
-      if (action == LINEFOLD_ACTION_DIRECT) {
-	if (lbclasses[idx-1] == LINEFOLD_CLASS_SP)
-	  lbactions[idx-1] = LINEFOLD_ACTION_INDIRECT;
-      } 
-      /* Indirect Break */
-      else if (action == LINEFOLD_ACTION_INDIRECT) {
-	if (lbclasses[idx-1] == LINEFOLD_CLASS_SP)
-	  lbactions[idx-1] = LINEFOLD_ACTION_INDIRECT;
-	else
-	  lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
-      } 
-      /* Indirect Break after combining mark(s) */
-      else if (action == LINEFOLD_ACTION_COMBINING_INDIRECT) {
+    /* Lookup pair table */
+    assert(before < LINEFOLD_CLASS_TABLESIZE);
+    assert(after < LINEFOLD_CLASS_TABLESIZE);
+    action = LBPAIR_ACTION(before, after);
+    /* Save line breaking action */
+    lbactions[idx-1] = action;
+
+    /* Direct Break */
+    if (action == LINEFOLD_ACTION_DIRECT) {
+      if (lbclasses[idx-1] == LINEFOLD_CLASS_SP)
+	lbactions[idx-1] = LINEFOLD_ACTION_INDIRECT;
+    } 
+    /* Indirect Break */
+    else if (action == LINEFOLD_ACTION_INDIRECT) {
+      if (lbclasses[idx-1] == LINEFOLD_CLASS_SP)
+	lbactions[idx-1] = LINEFOLD_ACTION_INDIRECT;
+      else
 	lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
-	if (lbclasses[idx-1] == LINEFOLD_CLASS_SP) {
-	  if (flags & LINEFOLD_OPTION_BREAK_SPCM)
-	    lbactions[idx-1] = LINEFOLD_ACTION_COMBINING_INDIRECT;
-	  else {
-	    lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
-	    if (idx - linestart > 1) {
-	      if (lbclasses[idx-2] == LINEFOLD_CLASS_SP)
-		lbactions[idx-2] = LINEFOLD_ACTION_INDIRECT;
-	      else
-		lbactions[idx-2] = LINEFOLD_ACTION_DIRECT;
-	    }
+    } 
+    /* Indirect Break after combining mark(s) */
+    else if (action == LINEFOLD_ACTION_COMBINING_INDIRECT) {
+      lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
+      if (lbclasses[idx-1] == LINEFOLD_CLASS_SP) {
+	if (flags & LINEFOLD_OPTION_BREAK_SPCM)
+	  lbactions[idx-1] = LINEFOLD_ACTION_COMBINING_INDIRECT;
+	else {
+	  lbactions[idx-1] = LINEFOLD_ACTION_PROHIBITED;
+	  if (base + idx - linestart > 1) {
+	    if (lbclasses[idx-2] == LINEFOLD_CLASS_SP)
+	      lbactions[idx-2] = LINEFOLD_ACTION_INDIRECT;
+	    else
+	      lbactions[idx-2] = LINEFOLD_ACTION_DIRECT;
 	  }
 	}
-	else
-	  continue;
       }
-      /* Prohibited Break with combining mark(s) */
-      else if (action == LINEFOLD_ACTION_COMBINING_PROHIBITED) {
-	lbactions[idx-1] = action;
-	if (lbclasses[idx-1] != LINEFOLD_CLASS_SP)
-	  continue;
-      } 
-
-      /* Save class of 'before' character */
-      before = lbclasses[idx];
-    } /* for () */
-      /* Always break at end of line. */
-    lbactions[idx-1] = LINEFOLD_ACTION_EXPLICIT;
-  }
-  /* End of text */
-  lbactions[textlen-1] = LINEFOLD_ACTION_EOT;
-    
-  return idx;
-}
-
-/* Internal default of function to check if length of a line exceeds
-   limit. */
+      else
+	continue;
+    }
+    /* Prohibited Break with combining mark(s) */
+    else if (action == LINEFOLD_ACTION_COMBINING_PROHIBITED) {
+      lbactions[idx-1] = action;
+      if (lbclasses[idx-1] != LINEFOLD_CLASS_SP)
+	continue;
+    } 
+
+    /* Save class of 'before' character */
+    before = after;
+  }
+
+  state->before = before;
+  state->linestart = linestart;
+}
+
 int
 linefold_is_line_excess(const struct linefold_info *lbinfo,
 			const linefold_char *text,
 			size_t start, size_t len, size_t maxlen,
 			void *voidarg)
+{
+  struct linefold_fit fit;
+
+  memset(&fit, 0, sizeof(struct linefold_fit));
+  return linefold_is_line_excess_incr(lbinfo, text, &fit, start, len,
+				      maxlen, voidarg);
+}
+
+/* Same as linefold_is_line_excess() but continues measuring from the
+   state of previous call for the same line. */
+int
+linefold_is_line_excess_incr(const struct linefold_info *lbinfo,
+			     const linefold_char *text,
+			     struct linefold_fit *fit,
+			     size_t start, size_t len, size_t maxlen,
+			     void *voidarg)
 {
   size_t end = start + len;
-  const linefold_width *widths = lbinfo->widths;
-  const linefold_class *lbclasses = lbinfo->lbclasses;
   linefold_flags flags = lbinfo->flags;
-  size_t i, length = 0, real_length = 0;
+  size_t i, length, real_length;
+
+  if (fit->start != start || fit->end < start || fit->maxlen != maxlen) {
+    fit->start = fit->end = start;
+    fit->maxlen = maxlen;
+    fit->length = fit->real_length = 0;
+    fit->excess = 0;
+  }
+  /* Shorter fragment than measured one fits. */
+  if (end <= fit->end)
+    return 0;
+  if (fit->excess)
+    return 1;
+  length = fit->length;
+  real_length = fit->real_length;
+
+  for (i=fit->end; i < end; i++) {
+    linefold_class lbc = LINEFOLD_LBCLASS(lbinfo, i);
+    linefold_width width = LINEFOLD_WIDTH(lbinfo, i);
 
-  for (i=start; i < end; i++) {
-    linefold_class lbc = lbclasses[i];
     if (lbc == LINEFOLD_CLASS_SP ||
 	lbc == LINEFOLD_CLASS_BK ||
 	lbc == LINEFOLD_CLASS_CR ||
@@ -568,43 +2918,57 @@ linefold_is_line_excess(const struct linefold_info *lbinfo,
        * choseong+jungseong or choseong+jungseong+jongseong
        * is single Wide character.
        */
-    } else if (lbc == LINEFOLD_CLASS_JV) {
-      if (!(flags & LINEFOLD_OPTION_NOCOMBINE_HANGUL_JAMO) &&
-	  i >= start+1 && lbclasses[i-1] == LINEFOLD_CLASS_JL)
-	real_length -= widths[i];
+    } else if (lbc == LINEFOLD_CLASS_JV || lbc == LINEFOLD_CLASS_JT) {
+      if (is_combined_jamo(lbinfo, start, i))
+	real_length -= width;
       else
-	length += widths[i];
-
-    } else if (lbc == LINEFOLD_CLASS_JT) {
-      if (!(flags & LINEFOLD_OPTION_NOCOMBINE_HANGUL_JAMO) &&
-	  i >= start+2 && lbclasses[i-2] == LINEFOLD_CLASS_JL &&
-	  lbclasses[i-1] == LINEFOLD_CLASS_JV)
-	real_length -= widths[i];
-      else
-	length += widths[i];
+	length += width;
 
     } else if (lbc == LINEFOLD_CLASS_CLH ||
 	       lbc == LINEFOLD_CLASS_CLHSP ||
 	       (lbc == LINEFOLD_CLASS_IDSP &&
 		!(flags & LINEFOLD_OPTION_NOHUNG_IDSP))) {
       if (real_length > maxlen)
-	length = real_length + widths[i];
+	length = real_length + width;
 
     } else if (lbc == LINEFOLD_CLASS_CLSP) {
-      if (real_length > maxlen - (widths[i] - 1))
-	length = real_length + widths[i];
+      if (real_length > maxlen - (width - 1))
+	length = real_length + width;
       else
-	length += widths[i]-1;
+	length += width-1;
 
     } else {
-      length = real_length + widths[i];
+      length = real_length + width;
     }
-    real_length += widths[i];
+    real_length += width;
 
     if (length > maxlen ||
 	(LINEFOLD_HARD_LIMIT > 0 &&
 	 real_length >= LINEFOLD_HARD_LIMIT))
+    {
+      fit->end = i;
+      fit->excess = 1;
       return 1;
+    }
   }
+  fit->end = end;
+  fit->length = length;
+  fit->real_length = real_length;
   return 0;
 }
+
+/* Same as linefold_is_line_excess() but takes offset and length in bytes
+   of UTF-8 text. */
+int
+linefold_is_line_excess_utf8(const struct linefold_info *lbinfo,
+			     const char *text,
+			     size_t start, size_t len, size_t maxlen,
+			     void *voidarg)
+{
+  size_t i = linefold_utf8_index(lbinfo, text, start);
+
+  return linefold_is_line_excess(lbinfo, NULL, i,
+				 linefold_utf8_index(lbinfo, text,
+						     start + len) - i,
+				 maxlen, voidarg);
+}
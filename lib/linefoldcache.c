@@ -0,0 +1,174 @@
+/*
+ * Process-wide cache of tailored character properties.
+ *
+ * Copyright (C) 2006 by Hatuka*nezumi - IKEDA Soji.  All rights reserved.
+ *
+ * This file is part of the Linefold Package.  This program is free
+ * software; you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.  This program is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the COPYING file for more details.
+ *
+ * $Id$
+ */
+
+#include "common.h"
+#include "linefold.h"
+#include "linefoldint.h"
+
+/* Maximum number of tables held at a time. */
+#define PROPCACHE_MAXENTRIES 16
+
+#if USE_PTHREAD
+
+static struct linefold_propcache *propcache_head = NULL;
+static size_t propcache_entries = 0;
+static pthread_mutex_t propcache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct linefold_propcache *
+propcache_build(linefold_lbprop_funcptr, linefold_flags);
+
+/*
+ * Get tables of properties got by lbprop_func then tailored by
+ * linefold_tailor_lbprop() with flags.  Tables are built at first call
+ * and shared by all threads.  NULL will be returned if tables couldn't
+ * be built.
+ */
+const struct linefold_propcache *
+linefold_propcache_get(linefold_lbprop_funcptr lbprop_func,
+		       linefold_flags flags)
+{
+  struct linefold_propcache *cache;
+
+  if (lbprop_func == NULL)
+    return NULL;
+  if (pthread_mutex_lock(&propcache_mutex) != 0)
+    return NULL;
+
+  for (cache = propcache_head; cache != NULL; cache = cache->next)
+    if (cache->lbprop_func == lbprop_func && cache->flags == flags)
+      break;
+  if (cache == NULL && propcache_entries < PROPCACHE_MAXENTRIES &&
+      (cache = propcache_build(lbprop_func, flags)) != NULL) {
+    cache->next = propcache_head;
+    propcache_head = cache;
+    propcache_entries++;
+  }
+
+  pthread_mutex_unlock(&propcache_mutex);
+
+  /* Entry without tables remembers that properties were too various. */
+  if (cache == NULL || cache->index == NULL)
+    return NULL;
+  return cache;
+}
+
+/* Build tables.  Caller must hold propcache_mutex. */
+static struct linefold_propcache *
+propcache_build(linefold_lbprop_funcptr lbprop_func, linefold_flags flags)
+{
+  struct linefold_propcache *cache;
+  unsigned short *index;
+  unsigned char *blocks, *block, *p;
+  unsigned long *hashes, hash;
+  size_t nvalues = 0, nblocks = 0, blk, i, j, v = 0;
+  linefold_char chars[PROPCACHE_BLOCKSIZE];
+  linefold_width widths[PROPCACHE_BLOCKSIZE], width;
+  linefold_class lbclasses[PROPCACHE_BLOCKSIZE], lbc;
+
+  if ((cache = malloc(sizeof(struct linefold_propcache))) == NULL)
+    return NULL;
+  cache->lbprop_func = lbprop_func;
+  cache->flags = flags;
+  cache->index = NULL;
+  cache->blocks = NULL;
+  cache->next = NULL;
+
+  if ((index = malloc(sizeof(unsigned short) * PROPCACHE_INDEXSIZE))
+      == NULL) {
+    free(cache);
+    return NULL;
+  }
+  if ((blocks = malloc(PROPCACHE_LIMIT)) == NULL) {
+    free(index);
+    free(cache);
+    return NULL;
+  }
+  if ((hashes = malloc(sizeof(unsigned long) * PROPCACHE_INDEXSIZE))
+      == NULL) {
+    free(blocks);
+    free(index);
+    free(cache);
+    return NULL;
+  }
+
+  for (blk = 0; blk < PROPCACHE_INDEXSIZE; blk++) {
+    block = blocks + (nblocks << PROPCACHE_SHIFT);
+    hash = 0;
+    for (i = 0; i < PROPCACHE_BLOCKSIZE; i++)
+      chars[i] = (linefold_char)((blk << PROPCACHE_SHIFT) + i);
+    linefold_getprop_bulk(lbprop_func, chars, PROPCACHE_BLOCKSIZE,
+			  widths, lbclasses);
+    for (i = 0; i < PROPCACHE_BLOCKSIZE; i++) {
+      width = widths[i];
+      lbc = lbclasses[i];
+      linefold_tailor_lbprop(chars[i], &width, &lbc, flags);
+
+      /* Runs of the same properties are usual. */
+      if (v < nvalues && cache->widths[v] == width &&
+	  cache->lbclasses[v] == lbc)
+	;
+      else {
+	for (v = 0; v < nvalues; v++)
+	  if (cache->widths[v] == width && cache->lbclasses[v] == lbc)
+	    break;
+	if (v == nvalues) {
+	  if (nvalues == PROPCACHE_MAXVALUES) {
+	    /* Too various: remember not to retry. */
+	    free(hashes);
+	    free(blocks);
+	    free(index);
+	    return cache;
+	  }
+	  cache->widths[v] = width;
+	  cache->lbclasses[v] = lbc;
+	  nvalues++;
+	}
+      }
+      block[i] = (unsigned char)v;
+      hash = hash * 31 + v;
+    }
+
+    /* Share identical blocks. */
+    for (j = 0; j < nblocks; j++)
+      if (hashes[j] == hash &&
+	  memcmp(blocks + (j << PROPCACHE_SHIFT), block,
+		 PROPCACHE_BLOCKSIZE) == 0)
+	break;
+    if (j == nblocks)
+      hashes[nblocks++] = hash;
+    index[blk] = (unsigned short)j;
+  }
+  free(hashes);
+
+  if ((p = realloc(blocks, nblocks << PROPCACHE_SHIFT)) != NULL)
+    blocks = p;
+  cache->index = index;
+  cache->blocks = blocks;
+  return cache;
+}
+
+#else /* USE_PTHREAD */
+
+/* Tables can't be shared safely without threads support. */
+const struct linefold_propcache *
+linefold_propcache_get(linefold_lbprop_funcptr lbprop_func,
+		       linefold_flags flags)
+{
+  return NULL;
+}
+
+#endif /* USE_PTHREAD */
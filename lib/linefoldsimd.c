@@ -0,0 +1,216 @@
+/*
+ * Classification of ASCII runs using SIMD instructions.
+ *
+ * Copyright (C) 2006 by Hatuka*nezumi - IKEDA Soji.  All rights reserved.
+ *
+ * This file is part of the Linefold Package.  This program is free
+ * software; you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.  This program is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the COPYING file for more details.
+ *
+ * $Id$
+ */
+
+#include "common.h"
+#include "linefold.h"
+#include "linefoldint.h"
+
+/*
+ * Kernels work on 32-bit characters, widths and classes: SSE2 tests four
+ * characters at once; AVX2 tests eight and gathers their properties.
+ */
+#if USE_SIMD && HAVE_IMMINTRIN_H && defined(__GNUC__) && \
+    defined(__x86_64__) && SIZEOF_LINEFOLD_CHAR == 4
+#    define SIMD_X86 1
+#    include <immintrin.h>
+#endif
+
+static size_t
+ascii_props_scalar(const linefold_char *, size_t,
+		   const linefold_width *, const linefold_class *,
+		   linefold_width *, linefold_class *);
+#if SIMD_X86
+static size_t
+ascii_props_sse2(const linefold_char *, size_t,
+		 const linefold_width *, const linefold_class *,
+		 linefold_width *, linefold_class *);
+static size_t
+ascii_props_avx2(const linefold_char *, size_t,
+		 const linefold_width *, const linefold_class *,
+		 linefold_width *, linefold_class *);
+
+/* 1: SSE2, 2: AVX2.  Set once by check_level(). */
+static int level = 0;
+
+static void
+check_level(void)
+{
+  __builtin_cpu_init();
+  level = (sizeof(linefold_width) == 4 && sizeof(linefold_class) == 4 &&
+	   __builtin_cpu_supports("avx2"))? 2: 1;
+}
+#endif /* SIMD_X86 */
+
+/*
+ * Find the best kernel the CPU supports: 0: scalar, 1: SSE2, 2: AVX2.
+ */
+int
+linefold_ascii_kernel(void)
+{
+#if SIMD_X86
+#    if USE_PTHREAD
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+  pthread_once(&once, check_level);
+#    else /* USE_PTHREAD */
+  if (level == 0)
+    check_level();
+#    endif /* USE_PTHREAD */
+  return level;
+#else /* SIMD_X86 */
+  return 0;
+#endif /* SIMD_X86 */
+}
+
+/*
+ * Get properties of leading ASCII characters by the best kernel the
+ * CPU supports.
+ */
+size_t
+linefold_ascii_props(const linefold_char *text, size_t len,
+		     const linefold_width *ascii_widths,
+		     const linefold_class *ascii_classes,
+		     linefold_width *widths, linefold_class *lbclasses)
+{
+  return linefold_ascii_props_kernel(linefold_ascii_kernel(), text, len,
+				     ascii_widths, ascii_classes,
+				     widths, lbclasses);
+}
+
+/*
+ * Get properties of leading ASCII characters by kernel, which must not
+ * be better than linefold_ascii_kernel() returns.
+ */
+size_t
+linefold_ascii_props_kernel(int kernel,
+			    const linefold_char *text, size_t len,
+			    const linefold_width *ascii_widths,
+			    const linefold_class *ascii_classes,
+			    linefold_width *widths, linefold_class *lbclasses)
+{
+#if SIMD_X86
+  if (kernel == 2)
+    return ascii_props_avx2(text, len, ascii_widths, ascii_classes,
+			    widths, lbclasses);
+  if (kernel == 1)
+    return ascii_props_sse2(text, len, ascii_widths, ascii_classes,
+			    widths, lbclasses);
+#endif /* SIMD_X86 */
+  return ascii_props_scalar(text, len, ascii_widths, ascii_classes,
+			    widths, lbclasses);
+}
+
+static size_t
+ascii_props_scalar(const linefold_char *text, size_t len,
+		   const linefold_width *ascii_widths,
+		   const linefold_class *ascii_classes,
+		   linefold_width *widths, linefold_class *lbclasses)
+{
+  size_t i;
+  unsigned long c;
+
+  for (i = 0; i < len; i++) {
+    if ((c = (unsigned long)text[i]) >= ASCII_TABSIZE)
+      break;
+    widths[i] = ascii_widths[c];
+    lbclasses[i] = ascii_classes[c];
+  }
+  return i;
+}
+
+#if SIMD_X86
+
+static size_t
+ascii_props_sse2(const linefold_char *text, size_t len,
+		 const linefold_width *ascii_widths,
+		 const linefold_class *ascii_classes,
+		 linefold_width *widths, linefold_class *lbclasses)
+{
+  const __m128i nonascii = _mm_set1_epi32(~(ASCII_TABSIZE - 1));
+  const __m128i zero = _mm_setzero_si128();
+  __m128i v;
+  size_t i = 0;
+
+  while (i + 4 <= len) {
+    v = _mm_and_si128(_mm_loadu_si128((const __m128i *)(text + i)),
+		      nonascii);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(v, zero)) != 0xFFFF)
+      break;
+    widths[i] = ascii_widths[text[i]];
+    widths[i+1] = ascii_widths[text[i+1]];
+    widths[i+2] = ascii_widths[text[i+2]];
+    widths[i+3] = ascii_widths[text[i+3]];
+    lbclasses[i] = ascii_classes[text[i]];
+    lbclasses[i+1] = ascii_classes[text[i+1]];
+    lbclasses[i+2] = ascii_classes[text[i+2]];
+    lbclasses[i+3] = ascii_classes[text[i+3]];
+    i += 4;
+  }
+  return i + ascii_props_scalar(text + i, len - i,
+				ascii_widths, ascii_classes,
+				widths + i, lbclasses + i);
+}
+
+__attribute__((target("avx2")))
+static size_t
+ascii_props_avx2(const linefold_char *text, size_t len,
+		 const linefold_width *ascii_widths,
+		 const linefold_class *ascii_classes,
+		 linefold_width *widths, linefold_class *lbclasses)
+{
+  const __m256i nonascii = _mm256_set1_epi32(~(ASCII_TABSIZE - 1));
+  __m256i v0, v1;
+  size_t i = 0;
+
+  /* Sixteen characters per iteration, then eight. */
+  while (i + 16 <= len) {
+    v0 = _mm256_loadu_si256((const __m256i *)(text + i));
+    v1 = _mm256_loadu_si256((const __m256i *)(text + i + 8));
+    if (!_mm256_testz_si256(_mm256_or_si256(v0, v1), nonascii))
+      break;
+    _mm256_storeu_si256((__m256i *)(widths + i),
+			_mm256_i32gather_epi32((const int *)ascii_widths,
+					       v0, 4));
+    _mm256_storeu_si256((__m256i *)(widths + i + 8),
+			_mm256_i32gather_epi32((const int *)ascii_widths,
+					       v1, 4));
+    _mm256_storeu_si256((__m256i *)(lbclasses + i),
+			_mm256_i32gather_epi32((const int *)ascii_classes,
+					       v0, 4));
+    _mm256_storeu_si256((__m256i *)(lbclasses + i + 8),
+			_mm256_i32gather_epi32((const int *)ascii_classes,
+					       v1, 4));
+    i += 16;
+  }
+  while (i + 8 <= len) {
+    v0 = _mm256_loadu_si256((const __m256i *)(text + i));
+    if (!_mm256_testz_si256(v0, nonascii))
+      break;
+    _mm256_storeu_si256((__m256i *)(widths + i),
+			_mm256_i32gather_epi32((const int *)ascii_widths,
+					       v0, 4));
+    _mm256_storeu_si256((__m256i *)(lbclasses + i),
+			_mm256_i32gather_epi32((const int *)ascii_classes,
+					       v0, 4));
+    i += 8;
+  }
+  return i + ascii_props_scalar(text + i, len - i,
+				ascii_widths, ascii_classes,
+				widths + i, lbclasses + i);
+}
+
+#endif /* SIMD_X86 */
@@ -65,6 +65,7 @@ const linefold_class LINEFOLD_CLASS_NL = 35;
 
 const linefold_class LINEFOLD_CLASS_USERDEFINED = 42;
 
+#if !LINEFOLD_LBPROP_TRIE
 /*
  * Character properties related on line breaking behavior.
  */
@@ -2407,6 +2408,1010 @@ static size_t lbprop_K_len = 126;
 static size_t lbprop_K_len = 21;
 #endif /* SIZEOF_LINEFOLD_CHAR */
 
+#else /* LINEFOLD_LBPROP_TRIE */
+/*
+ * Character properties related on line breaking behavior.
+ */
+typedef struct
+{
+	linefold_width  width;        /* UAX#11 East Asian Width */
+	linefold_class  lbclass;      /* UAX#14 Line Breaking Class */
+} lbprop_value;
+
+/*
+ * Unicode Character Property Trie
+ *
+ * Property of character c (0 <= c <= 0x10FFFF) is
+ *   lbprop_values[lbprop_blocks[(lbprop_index2[(index1[c >> 11] << 6) +
+ *                                              ((c >> 5) & 0x3F)] << 5) +
+ *                               (c & 0x1F)]].
+ */
+#define LBPROP_SHIFT1 11
+#define LBPROP_SHIFT2 5
+#define LBPROP_MAX 0x10FFFF
+
+static const lbprop_value lbprop_values[] = {
+    {1, 11 /* AL */},
+    {1, 19 /* CM */},
+    {1, 15 /* BA */},
+    {1, 34 /* LF */},
+    {1, 37 /* BKVT */},
+    {1, 36 /* BKFF */},
+    {1, 33 /* CR */},
+    {1, 31 /* SP */},
+    {1,  5 /* EX */},
+    {1,  2 /* QU */},
+    {1,  8 /* PR */},
+    {1,  9 /* PO */},
+    {1,  0 /* OP */},
+    {1,  1 /* CL */},
+    {1,  7 /* IS */},
+    {1, 14 /* HY */},
+    {1,  6 /* SY */},
+    {1, 10 /* NU */},
+    {1, 35 /* NL */},
+    {1,  3 /* GL */},
+    {1, 41 /* OPAL */},
+    {1, 16 /* BB */},
+    {0, 19 /* CM */},
+    {1, 12 /* ID */},
+    {1, 13 /* IN */},
+    {0,  3 /* GL */},
+    {2, 23 /* JL */},
+    {2, 24 /* JV */},
+    {2, 25 /* JT */},
+    {2, 19 /* CM */},
+    {1,  4 /* NS */},
+    {0, 18 /* ZW */},
+    {1, 17 /* B2 */},
+    {1, 38 /* INB2 */},
+    {1, 32 /* BK */},
+    {1, 39 /* NSEX */},
+    {1, 20 /* WJ */},
+    {2, 27 /* SPOP */},
+    {2, 29 /* CLSP */},
+    {2, 12 /* ID */},
+    {2, 26 /* IDSP */},
+    {2, 30 /* CLHSP */},
+    {2,  4 /* NS */},
+    {2, 17 /* B2 */},
+    {2, 40 /* NSK */},
+    {2,  9 /* PO */},
+    {2, 21 /* H2 */},
+    {2, 22 /* H3 */},
+    {2, 11 /* AL */},
+    {2,  7 /* IS */},
+    {2,  5 /* EX */},
+    {2, 38 /* INB2 */},
+    {2, 15 /* BA */},
+    {2,  8 /* PR */},
+    {1, 28 /* CLH */},
+    {2,  2 /* QU */},
+    {2, 13 /* IN */},
+    {2,  0 /* OP */},
+    {2,  1 /* CL */},
+    {2, 16 /* BB */},
+    {2, 41 /* OPAL */},
+};
+
+static const unsigned char lbprop_blocks[] = {
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   3,   4,   5,   6,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      7,   8,   9,  10,  10,  11,   0,   9,  12,  13,   0,  10,  14,  15,  14,  16,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  14,  14,   0,   0,   0,   8,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  12,  10,  13,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  12,   2,  13,   0,   1,
+      1,   1,   1,   1,   1,  18,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     19,  20,  11,  10,  10,  10,   0,   0,   0,   0,   0,   9,   0,   2,   0,   0,
+     11,  10,   0,   0,  21,  11,   0,   0,   0,   0,   0,   9,   0,   0,   0,  20,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,  21,   0,   0,   0,  21,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  19,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  19,  19,  19,  19,
+     19,  19,  19,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  14,   0,
+      0,   0,   0,  22,  22,  22,  22,   0,  22,  22,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  14,   2,   0,   0,   0,   0,   0,
+      0,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,   2,  22,
+      0,  22,  22,   0,  22,  22,   8,  22,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  11,   8,  14,   0,   0,
+     22,  22,  22,  22,  22,  22,   0,   0,   0,   0,   0,   8,   0,   0,   8,   8,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   8,  17,  17,   0,   0,   0,
+     22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   8,   0,  22,  22,  22,  22,  22,  22,  22,   0,  22,  22,
+     22,  22,  22,  22,  22,   0,   0,  22,  22,   0,  22,  22,  22,  22,   0,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,   0,   0,   0,   0,  14,   8,   0,   0,   0,   0,   0,   0,
+      0,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,   0,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,   0,   0,
+      0,  22,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,   2,   2,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,   0,   0,  22,  22,   0,   0,  22,  22,  22,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,  22,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,   0,   0,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+      0,   0,  10,  10,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,   0,   0,   0,   0,  22,  22,   0,   0,  22,  22,  22,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,  22,   0,  22,  22,  22,   0,  22,  22,  22,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,   0,   0,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+      0,  10,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,   0,   0,   0,  22,  22,   0,   0,  22,  22,  22,   0,   0,
+      0,   0,   0,   0,   0,   0,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,
+     22,  22,  22,   0,   0,   0,  22,  22,  22,   0,  22,  22,  22,  22,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,  22,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  10,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,   0,  22,  22,  22,   0,  22,  22,  22,  22,   0,   0,
+      0,   0,   0,   0,   0,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,   0,   0,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,   0,   0,  22,  22,  22,   0,  22,  22,  22,  22,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,  22,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,   0,   0,   0,   0,  22,
+     22,  22,  22,  22,  22,   0,  22,   0,  22,  22,  22,  22,  22,  22,  22,  22,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,
+     23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,
+     23,  23,   1,  23,   1,  23,   1,   1,  23,  23,  23,  23,  23,   1,  23,  24,
+      1,  25,   1,   1,  22,  22,  22,  22,  22,  22,  22,   0,   0,   0,   0,  10,
+     21,  21,  21,  21,  21,  21,  24,  22,  22,  22,  22,  22,  22,  22,  22,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   2,   2,   0,   0,   0,   0,
+      0,  23,  23,   0,  23,   0,   0,  23,  23,   0,  23,   0,   0,  23,   0,   0,
+      0,   0,   0,   0,  23,  23,  23,  23,   0,  23,  23,  23,  23,  23,  23,  23,
+      0,  23,   1,  23,   0,  23,   0,   1,   0,   0,  23,  23,   0,   1,  23,  24,
+      1,  25,   1,   1,  22,  22,  22,  22,  22,  22,   0,  22,  22,   1,   0,   0,
+     21,  21,  21,  21,  21,   0,  24,   0,  22,  22,  22,  22,  22,  22,   0,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   0,   0,  23,  23,   0,   0,
+      0,  21,  21,  21,  21,   0,  21,  21,  19,  21,  21,   2,  19,   8,   8,   8,
+      8,   8,  19,   0,   8,   0,   0,   0,  22,  22,   0,   0,   0,   0,   0,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   2,  22,   0,  22,   0,  22,  12,  13,  12,  13,  22,  22,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,   2,
+     22,  22,  22,  22,  22,   2,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,  22,  22,  22,   0,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,   0,   2,   2,
+      0,   0,   0,   0,   0,   0,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     21,  21,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,
+     23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,
+     23,  23,   0,   1,   1,   1,   1,   1,   0,   1,   1,   0,   1,  22,  22,  22,
+     22,   1,  22,   0,   0,   0,  22,  22,   1,  25,   0,   0,   0,   0,   0,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   2,   2,   0,   0,   0,   0,
+      1,   1,   1,   1,   1,   1,   1,   1,  22,  22,   0,   0,   0,   0,   0,   0,
+     26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,
+     26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,
+     26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,  26,
+     26,  26,  26,  26,  26,  26,  26,  26,  26,  26,   0,   0,   0,   0,   0,  26,
+     27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,
+     27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,
+     27,  27,  27,   0,   0,   0,   0,   0,  28,  28,  28,  28,  28,  28,  28,  28,
+     28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,
+     28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,
+     28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,
+     28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,  28,
+     28,  28,  28,  28,  28,  28,  28,  28,  28,  28,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,
+      0,   2,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      2,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  12,  13,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   2,   2,   2,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,  22,   2,   2,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     23,  23,  23,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,  22,  22,   1,  22,  22,  22,  22,  22,  22,  22,   1,  29,
+     29,   1,   1,   1,  29,  29,  22,   1,   1,  22,  22,  22,  22,  22,  22,  22,
+     22,  25,  25,  22,   2,   2,  30,  24,   2,   0,   2,  10,   1,  22,   0,   0,
+      0,   0,   2,   2,   2,   2,  21,   0,   2,   2,   0,  22,  22,  22,  19,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  22,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,   0,   0,   0,   0,
+      0,   0,   0,   0,   8,   8,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,  23,
+     23,  23,  23,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   0,   0,
+      1,   1,   1,   1,   1,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     23,  23,  23,  23,  23,  23,  23,  23,  23,  23,   0,   0,   0,   0,   0,   0,
+      1,   1,   1,   1,   1,   1,  29,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   0,   0,   0,   0,   0,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   0,   0,   0,   0,  23,  23,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  22,  22,   0,   0,   2,   0,
+     22,  22,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   2,   2,   2,   2,   2,   2,
+      2,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      2,   2,   2,   2,   2,   2,   2,  19,   2,   2,   2,  31,  22,  22,  22,  22,
+      2,  19,   2,   2,  32,   0,   0,   0,   9,   9,  12,   9,   9,   9,  12,   9,
+      0,   0,   0,   0,  24,  33,  33,   2,  34,  34,  22,  22,  22,  22,  22,  19,
+     11,  11,  11,  11,  11,  11,  11,  11,   0,   9,   9,   0,  35,  35,   0,   0,
+      0,   0,   0,   0,  14,  12,  13,  35,  35,  35,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   2,   0,   2,   2,   2,   2,   0,   2,   2,   2,
+     36,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  22,  22,  22,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  12,  13,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  12,  13,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     10,  10,  10,  10,  10,  10,  10,  11,  10,  10,  10,  10,  10,  10,  10,  10,
+     10,  10,  10,  10,  10,  10,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  11,   0,   0,   0,   0,   0,  11,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  11,   0,   0,  10,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  11,  11,   0,   0,   0,  11,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  10,  10,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  37,  38,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   9,   9,   9,   9,   0,
+      0,   0,   8,   8,   0,   0,   0,   0,  12,  13,  12,  13,  12,  13,  12,  13,
+     12,  13,  12,  13,  12,  13,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  12,  13,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  12,  13,  12,  13,  12,  13,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  12,  13,  12,  13,  12,  13,  12,  13,  12,  13,  12,  13,  12,
+     13,  12,  13,  12,  13,  12,  13,  12,  13,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,  12,  13,  12,  13,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  12,  13,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   2,   2,   2,   2,   0,   2,   2,
+      9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   2,   2,
+      2,   2,   2,   2,   2,   2,   0,   2,   0,   0,   0,   0,   9,   9,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,
+     40,  41,  41,  39,  39,  42,  39,  39,  37,  38,  37,  38,  37,  38,  37,  38,
+     37,  38,  39,  39,  37,  38,  37,  38,  37,  38,  37,  38,  42,  37,  38,  38,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  22,  22,  22,  22,  22,  22,
+     39,  39,  39,  43,  43,  43,  39,  39,  39,  39,  39,  42,  42,  39,  39,  23,
+      0,  44,  39,  44,  39,  44,  39,  44,  39,  44,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  44,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  44,  39,  44,  39,  44,  39,  39,  39,  39,  39,  39,  44,  39,
+     39,  39,  39,  39,  39,  44,  44,   0,   0,  22,  22,  42,  42,  42,  42,  39,
+     42,  44,  39,  44,  39,  44,  39,  44,  39,  44,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  44,  39,  44,  39,  44,  39,  39,  39,  39,  39,  39,  44,  39,
+     39,  39,  39,  39,  39,  44,  44,  39,  39,  39,  39,  42,  44,  42,  42,  39,
+      0,   0,   0,   0,   0,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,
+      0,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     44,  44,  44,  44,  44,  44,  44,  44,  44,  44,  44,  44,  44,  44,  44,  44,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,
+     39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  45,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  42,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,   0,   0,   0,  22,   0,   0,   0,   0,  22,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  22,  22,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,  21,  21,   8,   8,   0,   0,   0,   0,   0,   0,   0,   0,
+     46,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  46,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  46,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  46,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     46,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  46,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  46,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  46,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+     47,  47,  47,  47,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,
+     48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  12,  13,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  11,   0,   0,   0,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     49,  41,  41,  49,  49,  50,  50,  37,  38,  51,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     51,  43,  52,  39,  39,  37,  38,  37,  38,  37,  38,  37,  38,  37,  38,  37,
+     38,  37,  38,  37,  38,  39,  39,  37,  38,  39,  39,  39,  39,  39,  39,  39,
+     38,  39,  38,   0,  42,  42,  50,  50,  39,  37,  38,  37,  38,  37,  38,  39,
+     39,  39,  39,  39,  39,  39,  39,   0,  39,  53,  45,  39,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  36,
+      0,  50,  39,  39,  53,  45,  39,  39,  37,  38,  39,  39,  41,  39,  41,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  42,  42,  39,  39,  39,  50,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  37,  39,  38,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  37,  39,  38,  39,  37,
+     38,  54,  12,  13,  54,  30,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     45,  53,  39,  39,  39,  53,  53,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  23,   0,   0,   0,
+      2,   2,   2,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   2,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      2,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  22,  22,  22,   0,  22,  22,   0,   0,   0,   0,   0,  22,  22,  22,  22,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,   0,   0,   0,   0,  22,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      2,   2,   2,   2,   2,   2,   2,   2,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      2,   2,   2,   2,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  22,  22,  22,  22,  22,   0,   0,   0,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,   0,   0,  22,  22,  22,  22,  22,  22,  22,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  22,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  22,  22,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,
+     19,  20,  11,  10,  10,  10,   0,  48,   0,   0,   0,   9,   0,   2,   0,   0,
+     45,  53,   0,   0,  21,  11,   0,  48,   0,   0,   0,   9,   0,   0,   0,  20,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,  48,  21,  48,  48,  48,  21,  48,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,
+     22,  22,  22,  22,  22,  29,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+     22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,
+     48,  48,   0,  48,  48,  48,  48,  48,  48,  48,   0,   0,   0,   0,   0,   0,
+      0,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,
+     48,  48,   0,  48,  48,  48,  48,  48,  48,  48,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      2,   2,   2,   2,   2,   2,   2,  19,   2,   2,   2,  31,  22,  22,  22,  22,
+      2,  19,   2,  52,  43,   0,   0,   0,  55,  55,  12,   9,  55,  55,  12,   9,
+      0,   0,  39,   0,  56,  51,  51,  52,  34,  34,  22,  22,  22,  22,  22,  19,
+     11,  11,  45,  11,  11,  45,  11,  11,   0,   9,   9,  39,  35,  35,   0,   0,
+     53,  53,  53,  53,  53,  53,  53,  45,  53,  53,  53,  53,  53,  10,  10,  10,
+     10,  10,  10,  10,  10,  10,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  45,   0,  39,   0,   0,   0,  45,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  11,   0,   0,  10,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,   0,   0,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  10,  10,   0,  39,   0,   0,  39,  39,  39,   0,   0,   0,  39,  39,
+     39,   0,   0,  39,   0,  39,   0,   0,   0,  39,  39,  39,   0,   0,  39,   0,
+      0,   0,   0,   0,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,   0,  39,   0,   0,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  39,   0,   0,   0,  39,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  39,
+     39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,   0,
+     39,   0,   0,   0,  39,   0,   0,   0,  39,   0,   0,   0,  39,  39,   0,   0,
+      0,   0,   0,   0,  39,  39,   0,   0,   0,   0,   0,   0,  39,   0,   0,   0,
+      0,   0,   0,   0,  39,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,  39,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+      0,   0,   0,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,  39,  39,   0,   0,
+      0,   0,   0,   0,   0,   0,  39,  39,   0,   0,   0,  39,   0,   0,  39,  39,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  55,  55,  55,  55,  39,
+     39,  39,  50,  50,  39,  39,  39,  39,  57,  58,  57,  58,  57,  58,  57,  58,
+     57,  58,  57,  58,  57,  58,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     19,  20,  11,  10,  53,  10,   0,  48,  48,   0,   0,   9,   0,   2,   0,   0,
+     45,  53,   0,   0,  21,  11,   0,  48,   0,   0,   0,   9,   0,   0,   0,  20,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,  48,  21,  48,  48,  48,  21,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,
+      0,  48,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,
+     48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,
+      0,  48,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  48,   2,   2,   2,   2,  21,   0,   2,   2,   0,  22,  22,  22,  19,   0,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   0,   0,   0,   0,   0,   0,
+      2,   2,   2,   2,   2,   2,   2,  19,   2,   2,   2,  31,  22,  22,  22,  22,
+     52,  19,   2,  52,  43,  39,  39,   0,  55,  55,  12,   9,  55,  55,  12,   9,
+      0,   0,   0,   0,  24,  51,  51,   2,  34,  34,  22,  22,  22,  22,  22,  19,
+     45,  11,  45,  45,  11,  45,  11,  11,   0,   9,   9,  39,  35,  35,   0,   0,
+     10,  10,  10,  10,  10,  10,  10,  11,  10,  10,  10,  10,  53,  10,  10,  10,
+     10,  10,  10,  10,  10,  10,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  45,   0,  39,   0,   0,   0,  45,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  11,   0,   0,  53,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  39,   0,   0,   0,   0,  11,  11,   0,   0,   0,  11,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,   0,   0,   0,   0,  39,
+      0,  39,  10,  10,   0,  39,   0,   0,   0,   0,  39,   0,   0,  39,  39,  39,
+     39,   0,   0,  39,   0,  39,   0,  39,  39,  39,  39,  39,   0,   0,  39,   0,
+      0,   0,   0,   0,  39,  39,  39,  39,   0,   0,   0,   0,   0,  39,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,   0,  39,   0,   0,   0,
+      0,   0,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,   0,   0,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,  39,  39,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     19,  20,  11,  10,  10,  10,   0,  48,  48,   0,   0,   9,   0,   2,   0,   0,
+     45,  53,   0,   0,  59,  11,  48,   0,   0,   0,   0,   9,   0,   0,   0,  20,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  48,  48,  48,
+     48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,  48,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      2,  52,   2,  52,   2,   2,   2,  19,   2,   2,   2,  31,  22,  22,  22,  22,
+     52,  19,   2,   2,  43,  39,  39,   0,  55,  55,  12,   9,  55,  55,  12,   9,
+     39,  39,   0,   0,  24,  51,  51,   2,  34,  34,  22,  22,  22,  22,  22,  19,
+     45,  11,  45,  45,  11,  11,  11,  11,   0,   9,   9,  39,  35,  35,   0,   0,
+      0,   0,   0,  45,   0,   0,   0,   0,   0,  11,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  11,   0,   0,  53,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  39,   0,   0,   0,   0,  11,  11,   0,   0,   0,  45,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  39,   0,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,   0,  39,  39,   0,   0,   0,  39,  39,   0,   0,  39,   0,   0,   0,   0,
+      0,  39,  10,  10,   0,   0,   0,   0,   0,   0,  39,   0,   0,  39,  39,  39,
+     39,   0,   0,   0,   0,  39,   0,  39,  39,  39,  39,  39,  39,   0,  39,   0,
+      0,   0,   0,   0,  39,  39,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,
+     39,  39,   0,   0,   0,   0,  39,  39,   0,   0,  39,  39,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  39,  39,   0,   0,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,  39,
+     39,   0,   0,  39,  39,   0,   0,  39,  39,   0,   0,  39,  39,  39,   0,   0,
+     39,   0,   0,  39,  39,  39,   0,   0,  39,   0,   0,  39,  39,   0,   0,  39,
+     39,   0,   0,  39,  39,   0,   0,  39,  39,   0,   0,  39,  39,   0,   0,  39,
+      0,   0,  39,   0,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  39,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,  39,   0,  39,   0,   0,  39,   0,  39,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     45,  53,  39,  39,  39,  53,  53,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  23,  39,   0,   0,
+     19,  60,  11,  10,  53,  10,   0,  48,  48,   0,  48,   9,   0,  52,  48,   0,
+     45,  53,  48,  48,  59,  11,  48,  48,  48,  48,  48,   9,  48,  48,  48,  60,
+      0,   0,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     48,   0,   0,   0,   0,   0,   0,  48,  48,   0,   0,   0,   0,   0,  48,  48,
+      0,   0,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     48,   0,   0,   0,   0,   0,   0,  48,  48,   0,   0,   0,   0,   0,  48,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  48,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  48,  48,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  48,  48,  48,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,  48,
+     48,  48,  48,   0,   0,   0,   0,   0,   0,  48,  48,  48,   0,   0,   0,   0,
+      0,   0,  48,  48,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,  48,  48,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,  48,  21,   0,   0,   0,  21,   0,   0,   0,
+     48,   0,   0,   0,   0,   0,   0,   0,  48,  48,  48,  48,   0,  48,   0,   0,
+      2,   2,   2,   2,   2,   2,   2,  19,   2,   2,   2,  31,  22,  22,  22,  22,
+      2,  19,   2,   2,  43,  39,  39,   0,  55,  55,  12,   9,  55,  55,  12,   9,
+     36,   0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  22,  22,  22,
+      0,   0,   0,   0,  39,   0,   0,   0,   0,   0,   0,   0,   0,  12,  13,  39,
+      0,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,  12,  13,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  45,   0,   0,   0,   0,   0,  45,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  45,   0,   0,  53,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  39,  39,   0,   0,   0,  45,  11,   0,   0,   0,  45,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,  39,  39,   0,   0,   0,   0,   0,   0,  39,  39,  39,  39,   0,
+     39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,
+     39,   0,  39,  39,   0,   0,   0,  39,  39,   0,   0,  39,   0,   0,   0,  39,
+      0,  39,  10,  10,   0,   0,   0,   0,   0,   0,  39,   0,   0,  39,  39,   0,
+     39,   0,   0,   0,   0,  39,   0,  39,  39,  39,  39,  39,  39,   0,  39,   0,
+      0,   0,   0,   0,  39,  39,   0,   0,   0,   0,   0,   0,  39,  39,   0,   0,
+     39,  39,   0,   0,  39,  39,   0,   0,   0,   0,  39,  39,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  39,  39,   0,   0,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,  39,  39,   0,   0,   0,   0,   0,   0,   0,   0,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,   0,  39,  39,  39,  39,  39,  39,  39,   0,   0,   0,   0,   0,   0,
+      0,   0,  39,  39,   0,   0,  39,  39,   0,   0,   0,   0,  39,  39,   0,   0,
+     39,  39,   0,   0,   0,   0,  39,  39,  39,   0,   0,  39,   0,   0,  39,  39,
+     39,  39,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     39,  39,   0,  39,  39,  39,   0,  39,  39,  39,  39,   0,  39,  39,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     45,  53,  39,  39,  39,  53,  53,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  22,  22,  22,  39,   0,   0,   0,
+};
+
+static const unsigned short lbprop_index2[] = {
+      0,   1,   2,   3,   4,   5,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   7,   6,   8,   8,   9,  10,   6,   6,   6,   6,
+      6,   6,   6,   6,  11,   6,   6,   6,   6,   6,   6,   6,  12,  13,  14,   6,
+     15,   6,  16,  17,   6,   6,  18,  19,  20,  21,  22,   6,   6,  23,  24,  25,
+      6,   6,   6,   6,   6,   6,   6,   6,  26,  27,  28,  29,  26,  27,  30,  31,
+     26,  27,  32,  33,  26,  27,  34,  35,  26,  27,  36,  37,  38,  39,  40,  41,
+     26,  39,  42,  37,  43,  27,  42,  44,  43,  39,  45,  37,  43,   6,  46,  47,
+     48,  49,  50,   6,  51,  52,  53,   6,  54,  55,   6,  56,  57,  58,  59,   6,
+     60,  61,  62,   6,   6,   6,   6,   6,  63,  63,  64,  65,  65,  66,  67,  68,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,  69,  70,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,  71,   6,   6,  72,  73,  74,  47,  47,  60,  75,  76,  24,
+     77,   6,   6,   6,   6,  78,   6,   6,   6,  79,  80,  81,  60,  82,  83,   6,
+     84,   6,   6,   6,   6,   6,   6,   6,  85,  86,  87,  88,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,  22,  39,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+     89,  90,  91,  92,  93,  94,  21,  95,  96,  97,   6,   6,   6,   6,   6,   6,
+     98,   6,   6,   6,   6,   6,   6,   6,   6,  99,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6, 100, 101,   6,   6, 102, 103,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6, 104,   6, 105, 106,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6, 107,   6,   6,   6,   6,   6,   6,   6,   6,
+    108,   6,   6,   6, 109, 110, 110, 111, 110, 110, 110, 110, 110, 110, 112, 113,
+    114, 115, 116, 117, 118, 119, 117, 120, 121, 122, 110, 110, 123, 124, 125, 126,
+    127, 110, 128, 110, 110, 110, 110, 127, 110, 110, 110, 110, 110, 110, 129, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 112,   6,   6,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 130,   6,   6,
+    131, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 132, 110, 133,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+    134, 135,   6, 136,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+    137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138,
+    139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140,
+    141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142,
+    143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137,
+    138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139,
+    140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141,
+    142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143,
+    137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138,
+    139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140,
+    141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142,
+    143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137,
+    138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139,
+    140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141,
+    142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143,
+    137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138,
+    139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140,
+    141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142,
+    143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137,
+    138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139,
+    140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141,
+    142, 143, 137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 143,
+    137, 138, 139, 140, 141, 142, 143, 137, 138, 139, 140, 141, 142, 144,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+    145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145,
+    145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145,
+    145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145,
+    145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145,
+    145, 145, 145, 145, 145, 145, 145, 145, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 146, 110, 147, 110, 110, 148,   6, 149,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6, 150,   6,   6,   6,   6,   6, 151,
+    152, 153, 154, 155,   6,   6,   6, 156, 157, 158, 159, 160,   6,   6,   6, 161,
+      6,   6,   6,   6,   6,   6,   6,   6, 162,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6, 163,   6, 164,   6,
+      6,   6,   6,   6,   6,  24,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6, 163,   6,   6,   6,   6,   6,   6,   6,
+    165, 166, 167,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6, 168,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6, 169, 170, 171,   6,   6,
+      6,   6, 172,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6, 173, 174,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 175,
+      8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,  95,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+      0,   1,   2,   3,   4, 176, 177, 177,   6,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6, 178,   6, 179,   8,   9,  10, 180, 181, 182,   6,
+      6,   6,   6,   6,  11,   6,   6,   6,   6,   6,   6,   6,  12,  13,  14,   6,
+     15,   6,  16,  17,   6,   6,  18,  19,  20,  21,  22,   6,   6,  23,  24,  25,
+    183, 184,  91,  92,  93, 185,  21,  95, 186,  97,   6, 110, 187,   6,   6,   6,
+    188, 189, 190, 191, 192, 193,   6,   6,   6,  99,   6,   6,   6,   6,   6,   6,
+      6,   6,   6, 110, 110, 110, 110, 110, 194, 195, 196, 197, 198, 199, 200, 201,
+    110, 110, 110,   6,   6,   6,   6,   6, 110, 110, 202, 203, 110, 110, 102, 103,
+      0,   1,   2,   3,   4, 204, 177, 177,   6,   6,   6,   6,   6,   6,   6, 205,
+      6,   6,   6,   6,   6,   6, 206,   6,   8,   8,   9,  10, 180, 181, 182,   6,
+    207, 145, 208,   6,  11,   6,   6,   6,   6,   6,   6,   6,  12,  13,  14,   6,
+     15,   6,  16,  17,   6,   6,  18,  19,  20,  21,  22,   6,   6,  23,  24,  25,
+    209,   6,   6,   6,   6,  78,   6,   6,   6,  79,  80,  81,  60,  82,  83,   6,
+     84,   6,   6,   6,   6,   6,   6,   6,  85,  86,  87,  88,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,  22,  39,
+      6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,
+    210, 211,  91,  92,  93, 212,  21,  95, 213, 214,   6, 110, 187,   6,   6,   6,
+    215, 216, 217, 218, 192, 193,   6,   6, 190,  99,   6,   6,   6,   6,   6,   6,
+      6,   6,   6, 110, 110, 110, 110, 110, 110, 110, 110, 111, 198, 199, 200, 201,
+    110, 110, 110,   6,   6,   6,   6,   6, 110, 110, 202, 203, 110, 110, 102, 103,
+      0,   1,   2,   3,   4, 219, 177, 177,   6,   6,   6,   6,   6,   6, 220, 221,
+      6,   6,   6,   6,   6,   6,   7,   6,   8,   8,   9,  10, 180, 181, 182,   6,
+    207, 145, 208,   6,  11,   6,   6,   6,   6,   6,   6,   6,  12,  13,  14,   6,
+     15,   6,  16,  17,   6,   6,  18,  19,  20,  21,  22,   6,   6,  23,  24,  25,
+    222, 223,  91,  92,  93,  94,  21,  95, 224, 225,   6, 110, 226,   6, 227,   6,
+    228, 229, 190, 230, 231, 193,   6,   6, 190,  99,   6,   6,   6,   6,   6,   6,
+      6,   6,   6, 110, 110, 110, 110, 110, 232, 233, 234,   6,   6, 199, 200, 235,
+    110, 110, 110, 236,   6,   6,   6,   6, 110, 110, 202, 203, 110, 110, 102, 103,
+    145, 145, 145, 145, 145, 145, 145, 145, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 146, 110, 147, 110, 110, 148,   6, 149,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6, 150,   6,   6,   6,   6,   6, 151,
+    152, 153, 154, 155,   6,   6,   6, 156, 157, 158, 159, 160,   6,   6,   6, 237,
+      0,   1,   2,   3,   4, 238, 239, 240, 241, 242, 243, 244,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6, 245,   6,   8,   8,   9,  10, 180, 181, 182,   6,
+    207, 145, 208,   6,  11,   6,   6,   6,   6,   6,   6,   6,  12,  13,  14,   6,
+     15,   6,  16,  17,   6,   6,  18,  19,  20,  21,  22,   6,   6,  23,  24,  25,
+    246, 223,  91, 247, 248, 212,  21,  95, 249, 250, 251, 110, 252,   6, 227,   6,
+    253, 254, 190, 255, 256, 257,   6,   6, 190,  99,   6,   6,   6,   6,   6,   6,
+      6,   6,   6, 110, 110, 110, 110, 110, 258, 110, 259,   6, 190, 260, 261,   6,
+    110, 110, 110, 262,   6,   6,   6,   6, 110, 110, 202, 203, 110, 110, 102, 103,
+    145, 145, 145, 145, 145, 145, 145, 145, 110, 110, 110, 110, 110, 110, 110, 110,
+    110, 146, 110, 147, 110, 110, 148,   6, 149,   6,   6,   6,   6,   6,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   6, 150,   6,   6,   6,   6,   6, 151,
+    152, 153, 154, 155,   6,   6,   6, 156, 157, 158, 159, 160,   6,   6,   6, 263,
+};
+
+static const unsigned char lbprop_index1[] = {
+      0,   1,   2,   3,   4,   5,   6,   7,   7,   8,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   9,  10,  11,  12,  13,  14,  15,  16,  17,  18,  18,  18,  19,
+     20,  21,  17,  17,  22,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  23,  17,  17,  17,  17,  17,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     25,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+};
+
+static const unsigned char lbprop_C_index1[] = {
+     26,   1,   2,   3,  27,   5,   6,   7,   7,   8,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   9,  10,  11,  12,  13,  14,  15,  16,  17,  18,  18,  18,  19,
+     20,  21,  17,  17,  22,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  23,  17,  17,  17,  17,  17,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     25,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+};
+
+static const unsigned char lbprop_G_index1[] = {
+     28,   1,   2,  29,  30,   5,   6,   7,   7,   8,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   9,  10,  11,  12,  13,  14,  15,  16,  17,  18,  18,  18,  19,
+     20,  21,  17,  17,  22,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  23,  17,  17,  17,  17,  17,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     25,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+};
+
+static const unsigned char lbprop_J_index1[] = {
+     31,   1,   2,   3,  32,   5,   6,   7,   7,   8,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   9,  10,  11,  12,  13,  14,  15,  16,  17,  18,  18,  18,  33,
+     20,  21,  17,  17,  22,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  23,  17,  17,  17,  17,  17,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     25,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+};
+
+static const unsigned char lbprop_K_index1[] = {
+     34,   1,   2,   3,  35,   5,   6,   7,   7,   8,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   9,  10,  11,  12,  13,  14,  15,  16,  17,  18,  18,  18,  36,
+     20,  21,  17,  17,  22,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  23,  17,  17,  17,  17,  17,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,  24,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     25,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+};
+
+static const lbprop_value *find_lbprop(const unsigned char *index1,
+                                       linefold_char c)
+{
+	unsigned long u = (unsigned long)c;
+	unsigned int i;
+
+	if (LBPROP_MAX < u)
+		return lbprop_values;
+	i = lbprop_index2[((unsigned int)index1[u >> LBPROP_SHIFT1]
+	                   << (LBPROP_SHIFT1 - LBPROP_SHIFT2)) +
+	                  ((u >> LBPROP_SHIFT2) &
+	                   ((1 << (LBPROP_SHIFT1 - LBPROP_SHIFT2)) - 1))];
+	return lbprop_values + lbprop_blocks[(i << LBPROP_SHIFT2) +
+	                                     (u & ((1 << LBPROP_SHIFT2) - 1))];
+}
+
+/* Neighboring characters usually share a block: look it up once. */
+static void find_lbprop_bulk(const unsigned char *index1,
+                             const linefold_char *text, size_t len,
+                             linefold_width *widths, linefold_class *lbclasses)
+{
+	const unsigned char *block = lbprop_blocks;
+	const lbprop_value *ucp;
+	unsigned long u, blk = (unsigned long)-1;
+	size_t n;
+
+	for (n = 0; n < len; n++) {
+		u = (unsigned long)text[n];
+		if ((u >> LBPROP_SHIFT2) == blk)
+			ucp = lbprop_values + block[u & ((1 << LBPROP_SHIFT2) - 1)];
+		else if (LBPROP_MAX < u)
+			ucp = lbprop_values;
+		else {
+			blk = u >> LBPROP_SHIFT2;
+			block = lbprop_blocks +
+			    ((unsigned int)lbprop_index2[
+			        ((unsigned int)index1[u >> LBPROP_SHIFT1]
+			         << (LBPROP_SHIFT1 - LBPROP_SHIFT2)) +
+			        (blk & ((1 << (LBPROP_SHIFT1 - LBPROP_SHIFT2)) - 1))]
+			     << LBPROP_SHIFT2);
+			ucp = lbprop_values + block[u & ((1 << LBPROP_SHIFT2) - 1)];
+		}
+		if (widths)
+			widths[n] = ucp->width;
+		if (lbclasses)
+			lbclasses[n] = ucp->lbclass;
+	}
+}
+
+#endif /* LINEFOLD_LBPROP_TRIE */
+
 /*
  * UAX #14 Line Breaking Class pair table.
  */
@@ -2515,10 +3520,47 @@ const linefold_action *linefold_lbpairs[] =
   row_CLHSP
 };
 
+/* Same table packed into a matrix of bytes, for use by the library. */
+const unsigned char linefold_lbpairs_packed[31 * 31] =
+{
+  /* OP    */ X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,Xc,X,X,X,X,X,X,X,X,X,X,X,
+  /* CL    */ D,X,I,I,X,X,X,X,I,I,I,I,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* QU    */ X,X,I,I,I,X,X,X,I,I,I,I,I,I,I,I,I,I,X,Ic,X,I,I,I,I,I,I,X,X,X,X,
+  /* GL    */ I,X,I,I,I,X,X,X,I,I,I,I,I,I,I,I,I,I,X,Ic,X,I,I,I,I,I,I,I,X,X,X,
+  /* NS    */ D,X,I,I,I,X,X,X,D,D,D,D,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* EX    */ D,X,I,I,I,X,X,X,D,D,D,D,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,I,D,X,X,X,
+  /* SY    */ D,X,I,I,I,X,X,X,D,D,I,D,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* IS    */ D,X,I,I,I,X,X,X,D,D,I,I,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* PR    */ I,X,I,I,I,X,X,X,D,D,I,I,I,D,I,I,D,D,X,Ic,X,I,I,I,I,I,I,D,X,X,X,
+  /* PO    */ I,X,I,I,I,X,X,X,D,D,I,I,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* NU    */ I,X,I,I,I,X,X,X,I,I,I,I,D,I,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* AL    */ I,X,I,I,I,X,X,X,D,D,I,I,D,I,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* ID    */ D,X,I,I,I,X,X,X,D,I,D,D,D,I,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* IN    */ D,X,I,I,I,X,X,X,D,D,D,D,D,I,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* HY    */ D,X,I,I,I,X,X,X,D,D,I,D,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* BA    */ D,X,I,I,I,X,X,X,D,D,D,D,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* BB    */ I,X,I,I,I,X,X,X,I,I,I,I,I,I,I,I,I,I,X,Ic,X,I,I,I,I,I,I,I,X,X,X,
+  /* B2    */ D,X,I,I,I,X,X,X,D,D,D,D,D,D,I,I,D,X,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* ZW    */ D,D,D,D,D,D,D,D,D,D,D,D,D,D,D,D,D,D,X,D,D,D,D,D,D,D,D,D,D,D,D,
+  /* CM    */ I,X,I,I,I,X,X,X,D,D,I,I,D,I,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* WJ    */ I,X,I,I,I,X,X,X,I,I,I,I,I,I,I,I,I,I,X,Ic,X,I,I,I,I,I,I,I,X,X,X,
+  /* H2    */ D,X,I,I,I,X,X,X,D,I,D,D,D,I,I,I,D,D,X,Ic,X,D,D,D,I,I,D,D,X,X,X,
+  /* H3    */ D,X,I,I,I,X,X,X,D,I,D,D,D,I,I,I,D,D,X,Ic,X,D,D,D,D,I,D,D,X,X,X,
+  /* JL    */ D,X,I,I,I,X,X,X,D,I,D,D,D,I,I,I,D,D,X,Ic,X,I,I,I,I,D,D,D,X,X,X,
+  /* JV    */ D,X,I,I,I,X,X,X,D,I,D,D,D,I,I,I,D,D,X,Ic,X,D,D,D,I,I,D,D,X,X,X,
+  /* JT    */ D,X,I,I,I,X,X,X,D,I,D,D,D,I,I,I,D,D,X,Ic,X,D,D,D,D,I,D,D,X,X,X,
+  /* IDSP  */ D,X,I,I,I,X,X,X,D,I,D,D,D,I,I,I,D,D,X,Ic,X,D,D,D,D,D,I,D,X,X,X,
+  /* SPOP  */ X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,Xc,X,X,X,X,X,X,X,X,X,X,X,
+  /* CLH   */ D,X,I,I,X,X,X,X,I,I,I,I,D,D,I,I,D,D,X,Ic,X,D,D,D,D,D,D,D,X,X,X,
+  /* CLSP  */ D,X,D,D,X,X,X,X,D,D,D,D,D,D,D,D,D,D,X,D,X,D,D,D,D,D,D,D,X,X,X,
+  /* CLHSP */ D,X,D,D,X,X,X,X,D,D,D,D,D,D,D,D,D,D,X,D,X,D,D,D,D,D,D,D,X,X,X
+};
+
 /*
  * Functions to get property
  */
 
+#if !LINEFOLD_LBPROP_TRIE
 static lbprop lbprop_unknown[1] =
 {
 	{0, 0, 1, 11 /* AL */}
@@ -2608,3 +3650,153 @@ void linefold_getprop_K(linefold_char c,
 		*lbcptr = ucp->lbclass;
 }
 
+void linefold_getprop_bulk_generic(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	size_t n;
+	for (n = 0; n < len; n++)
+		linefold_getprop_generic(text[n],
+		                  widths? widths+n: NULL,
+		                  lbclasses? lbclasses+n: NULL);
+}
+
+void linefold_getprop_bulk_C(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	size_t n;
+	for (n = 0; n < len; n++)
+		linefold_getprop_C(text[n],
+		                  widths? widths+n: NULL,
+		                  lbclasses? lbclasses+n: NULL);
+}
+
+void linefold_getprop_bulk_G(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	size_t n;
+	for (n = 0; n < len; n++)
+		linefold_getprop_G(text[n],
+		                  widths? widths+n: NULL,
+		                  lbclasses? lbclasses+n: NULL);
+}
+
+void linefold_getprop_bulk_J(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	size_t n;
+	for (n = 0; n < len; n++)
+		linefold_getprop_J(text[n],
+		                  widths? widths+n: NULL,
+		                  lbclasses? lbclasses+n: NULL);
+}
+
+void linefold_getprop_bulk_K(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	size_t n;
+	for (n = 0; n < len; n++)
+		linefold_getprop_K(text[n],
+		                  widths? widths+n: NULL,
+		                  lbclasses? lbclasses+n: NULL);
+}
+
+#else /* LINEFOLD_LBPROP_TRIE */
+/* Generic */
+void linefold_getprop_generic(linefold_char c,
+                              linefold_width *widthptr, linefold_class *lbcptr)
+{
+	const lbprop_value *ucp = find_lbprop(lbprop_index1, c);
+	if (widthptr)
+		*widthptr = ucp->width;
+	if (lbcptr)
+		*lbcptr = ucp->lbclass;
+}
+
+void linefold_getprop_C(linefold_char c,
+                        linefold_width *widthptr, linefold_class *lbcptr)
+{
+	const lbprop_value *ucp = find_lbprop(lbprop_C_index1, c);
+	if (widthptr)
+		*widthptr = ucp->width;
+	if (lbcptr)
+		*lbcptr = ucp->lbclass;
+}
+
+void linefold_getprop_G(linefold_char c,
+                        linefold_width *widthptr, linefold_class *lbcptr)
+{
+	const lbprop_value *ucp = find_lbprop(lbprop_G_index1, c);
+	if (widthptr)
+		*widthptr = ucp->width;
+	if (lbcptr)
+		*lbcptr = ucp->lbclass;
+}
+
+void linefold_getprop_J(linefold_char c,
+                        linefold_width *widthptr, linefold_class *lbcptr)
+{
+	const lbprop_value *ucp = find_lbprop(lbprop_J_index1, c);
+	if (widthptr)
+		*widthptr = ucp->width;
+	if (lbcptr)
+		*lbcptr = ucp->lbclass;
+}
+
+void linefold_getprop_K(linefold_char c,
+                        linefold_width *widthptr, linefold_class *lbcptr)
+{
+	const lbprop_value *ucp = find_lbprop(lbprop_K_index1, c);
+	if (widthptr)
+		*widthptr = ucp->width;
+	if (lbcptr)
+		*lbcptr = ucp->lbclass;
+}
+
+void linefold_getprop_bulk_generic(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	find_lbprop_bulk(lbprop_index1, text, len, widths, lbclasses);
+}
+
+void linefold_getprop_bulk_C(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	find_lbprop_bulk(lbprop_C_index1, text, len, widths, lbclasses);
+}
+
+void linefold_getprop_bulk_G(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	find_lbprop_bulk(lbprop_G_index1, text, len, widths, lbclasses);
+}
+
+void linefold_getprop_bulk_J(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	find_lbprop_bulk(lbprop_J_index1, text, len, widths, lbclasses);
+}
+
+void linefold_getprop_bulk_K(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	find_lbprop_bulk(lbprop_K_index1, text, len, widths, lbclasses);
+}
+
+#endif /* LINEFOLD_LBPROP_TRIE */
+
+/* Get bulk version of function to get property, or NULL if unknown. */
+linefold_lbprop_bulk_funcptr
+linefold_find_lbprop_bulk_func(linefold_lbprop_funcptr lbprop_func)
+{
+	if (lbprop_func == &linefold_getprop_generic)
+		return &linefold_getprop_bulk_generic;
+	if (lbprop_func == &linefold_getprop_C)
+		return &linefold_getprop_bulk_C;
+	if (lbprop_func == &linefold_getprop_G)
+		return &linefold_getprop_bulk_G;
+	if (lbprop_func == &linefold_getprop_J)
+		return &linefold_getprop_bulk_J;
+	if (lbprop_func == &linefold_getprop_K)
+		return &linefold_getprop_bulk_K;
+	return NULL;
+}
@@ -59,6 +59,15 @@ LBRULEHTML = 'linebreakrule.html'
 # My name.
 MYNAME = os.path.split(sys.argv[0])[-1]
 
+# Properties of characters beyond SMP, not listed in data files.
+SUPPLEMENTARY_PROPS = [
+    (0x20000, 0x2FFFD, 2, 'ID', 'Supplemental Ideographs'),
+    (0x30000, 0x3FFFD, 2, 'ID', 'Ideographs in the future'),
+    (0xE0000, 0xE01EF, 0, 'CM', 'Tags'),
+    (0xF0000, 0xFFFFD, 1, 'AL', 'Plane 15 Private Use'),
+    (0x100000, 0x10FFFD, 1, 'AL', 'Plane 16 Private Use'),
+    ]
+
 ###
 ### Read Properties.
 ###
@@ -207,6 +216,7 @@ const linefold_class LINEFOLD_CLASS_USERDEFINED = %2d;
 """ % idx
 
 print >>fp, """\
+#if !LINEFOLD_LBPROP_TRIE
 /*
  * Character properties related on line breaking behavior.
  */
@@ -226,13 +236,14 @@ typedef struct
 # Write generic property map.
 print >>fp, "static lbprop lbprop_tab[] = {"
 num4, num2, num1 = printpropmap(fp, propmap, class_idx)
+print >>fp, "#if SIZEOF_LINEFOLD_CHAR > 2"
+entries = ['    {0x%04X, 0x%04X, %d, %2d /* %s */},' % \
+           (start, end, width, class_idx[lbc], lbc)
+           for start, end, width, lbc, desc in SUPPLEMENTARY_PROPS]
+entwidth = max([len(ent) for ent in entries])
+for ent, prop in zip(entries, SUPPLEMENTARY_PROPS):
+    print >>fp, '%-*s /* %s */' % (entwidth, ent, prop[4])
 print >>fp, """\
-#if SIZEOF_LINEFOLD_CHAR > 2
-    {0x20000, 0x2FFFD, 2, %(ID)2d /* ID */},   /* Supplemental Ideographs */
-    {0x30000, 0x3FFFD, 2, %(ID)2d /* ID */},   /* Ideographs in the future */
-    {0xE0000, 0xE01EF, 0, %(CM)2d /* CM */},   /* Tags */
-    {0xF0000, 0xFFFFD, 1, %(AL)2d /* AL */},   /* Plane 15 Private Use */
-    {0x100000, 0x10FFFD, 1, %(AL)2d /* AL */}, /* Plane 16 Private Use */
 #endif /* SIZEOF_LINEFOLD_CHAR > 2 */
     {0, 0, 0, 0}
 };
@@ -244,12 +255,9 @@ static size_t lbprop_len = %(num2)d;
 #else
 static size_t lbprop_len = %(num1)d;
 #endif /* SIZEOF_LINEFOLD_CHAR */
-""" % { 'num4': num4+5,
+""" % { 'num4': num4+len(SUPPLEMENTARY_PROPS),
         'num2': num2,
         'num1': num1,
-        'AL': class_idx['AL'],
-        'CM': class_idx['CM'],
-        'ID': class_idx['ID'],
         }
 
 ## Write property maps with custom widths.
@@ -271,6 +279,23 @@ static size_t lbprop_%(r)s_len = %(num1)d;
 #endif /* SIZEOF_LINEFOLD_CHAR */
 """ % {'r': r, 'num4': num4, 'num2': num2, 'num1': num1,}
 
+## Write property tries.
+print >>fp, "#else /* LINEFOLD_LBPROP_TRIE */"
+trieprops = {}
+for u, v in propmap.items():
+    trieprops[u] = v
+for start, end, width, lbc, desc in SUPPLEMENTARY_PROPS:
+    for u in range(start, end+1):
+        trieprops[u] = (width, lbc)
+triemaps = [('', trieprops)]
+for r in lmkeys:
+    m = trieprops.copy()
+    m.update(legacy_maps[r])
+    triemaps.append(('_' + r, m))
+printproptrie(fp, triemaps, class_idx, (1, 'AL'))
+print >>fp, "#endif /* LINEFOLD_LBPROP_TRIE */"
+print >>fp, ""
+
 ## Generate line breaking class pair table and write it.
 print >>fp, """\
 /*
@@ -291,6 +316,7 @@ print >>fp, """\
  * Functions to get property
  */
 
+#if !LINEFOLD_LBPROP_TRIE
 static lbprop lbprop_unknown[1] =
 {
 	{0, 0, 1, %(AL)2d /* AL */}
@@ -343,6 +369,68 @@ void linefold_getprop_%(region)s(linefold_char c,
 		*lbcptr = ucp->lbclass;
 }
 """ % { 'region': r }
+for r in ['generic'] + lmkeys:
+    print >>fp, """\
+void linefold_getprop_bulk_%(region)s(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	size_t n;
+	for (n = 0; n < len; n++)
+		linefold_getprop_%(region)s(text[n],
+		                  widths? widths+n: NULL,
+		                  lbclasses? lbclasses+n: NULL);
+}
+""" % { 'region': r }
+print >>fp, """\
+#else /* LINEFOLD_LBPROP_TRIE */
+/* Generic */
+void linefold_getprop_generic(linefold_char c,
+                              linefold_width *widthptr, linefold_class *lbcptr)
+{
+	const lbprop_value *ucp = find_lbprop(lbprop_index1, c);
+	if (widthptr)
+		*widthptr = ucp->width;
+	if (lbcptr)
+		*lbcptr = ucp->lbclass;
+}
+"""
+for r in lmkeys:
+    print >>fp, """\
+void linefold_getprop_%(region)s(linefold_char c,
+                        linefold_width *widthptr, linefold_class *lbcptr)
+{
+	const lbprop_value *ucp = find_lbprop(lbprop_%(region)s_index1, c);
+	if (widthptr)
+		*widthptr = ucp->width;
+	if (lbcptr)
+		*lbcptr = ucp->lbclass;
+}
+""" % { 'region': r }
+for r in ['generic'] + lmkeys:
+    if r == 'generic':
+        index1 = 'lbprop_index1'
+    else:
+        index1 = 'lbprop_%s_index1' % r
+    print >>fp, """\
+void linefold_getprop_bulk_%(region)s(const linefold_char *text, size_t len,
+                        linefold_width *widths, linefold_class *lbclasses)
+{
+	find_lbprop_bulk(%(index1)s, text, len, widths, lbclasses);
+}
+""" % { 'region': r, 'index1': index1 }
+print >>fp, "#endif /* LINEFOLD_LBPROP_TRIE */"
+print >>fp, """
+/* Get bulk version of function to get property, or NULL if unknown. */
+linefold_lbprop_bulk_funcptr
+linefold_find_lbprop_bulk_func(linefold_lbprop_funcptr lbprop_func)
+{"""
+for r in ['generic'] + lmkeys:
+    print >>fp, """\
+	if (lbprop_func == &linefold_getprop_%(region)s)
+		return &linefold_getprop_bulk_%(region)s;""" % { 'region': r }
+print >>fp, """\
+	return NULL;
+}"""
 
 fp.close()
 
@@ -378,7 +466,8 @@ print >>fp, ""
 print >>fp, """\
 /* Placeholder to indicate end of ordinal classes. */
 extern const linefold_class LINEFOLD_CLASS_TABLESIZE;
-"""
+#define LINEFOLD_LBPAIRS_SIZE %d
+""" % len(ORDINAL_CLASSES)
 
 print >>fp, """\
 /*
@@ -424,6 +513,14 @@ for r in lmkeys:
 extern void linefold_getprop_%(region)s(linefold_char,
                                linefold_width *, linefold_class *);\
 """ % { 'region': r }
+print >>fp, """\
+extern void linefold_getprop_bulk_generic(const linefold_char *, size_t,
+                                          linefold_width *, linefold_class *);"""
+for r in lmkeys:
+    print >>fp, """\
+extern void linefold_getprop_bulk_%(region)s(const linefold_char *, size_t,
+                                    linefold_width *, linefold_class *);\
+""" % { 'region': r }
 print >>fp, ''
 print >>fp, '#endif /* LINEFOLDTAB_H */'
 fp.close()
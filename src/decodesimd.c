@@ -0,0 +1,354 @@
+/*
+ * decodesimd.c - Decoding ASCII and UTF-8 runs using SIMD instructions.
+ *
+ * Copyright (C) 2006 by Hatuka*nezumi - IKEDA Soji.  All rights reserved.
+ *
+ * This file is part of the Linefold Package.  This program is free
+ * software; you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.  This program is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the COPYING file for more details.
+ *
+ * $id$
+ */
+
+#include "common.h"
+#include "linefold.h"
+
+/*
+ * Kernels validate bytes and widen them to 32-bit characters: SSE2 takes
+ * sixteen bytes at once; AVX2 takes thirty-two.  UTF-8 sequences of two
+ * and three bytes are decoded by AVX2 only, eight bytes at once.
+ */
+#if USE_SIMD && HAVE_IMMINTRIN_H && defined(__GNUC__) && \
+    defined(__x86_64__) && SIZEOF_LINEFOLD_CHAR == 4
+#    define SIMD_X86 1
+#    include <immintrin.h>
+#endif
+
+static size_t
+ascii_run_scalar(const unsigned char *, size_t, linefold_char *);
+#if SIMD_X86
+static size_t
+ascii_run_sse2(const unsigned char *, size_t, linefold_char *);
+static size_t
+ascii_run_avx2(const unsigned char *, size_t, linefold_char *);
+static size_t
+utf8_run_avx2(const unsigned char *, size_t, linefold_char *, size_t *);
+
+/*
+ * Lanes to be gathered: for each of byte masks of heads of characters,
+ * indice of set bits packed into bytes.
+ */
+static const unsigned long long utf8_compact[256] = {
+  0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000001ULL,
+  0x0000000000000100ULL, 0x0000000000000002ULL, 0x0000000000000200ULL,
+  0x0000000000000201ULL, 0x0000000000020100ULL, 0x0000000000000003ULL,
+  0x0000000000000300ULL, 0x0000000000000301ULL, 0x0000000000030100ULL,
+  0x0000000000000302ULL, 0x0000000000030200ULL, 0x0000000000030201ULL,
+  0x0000000003020100ULL, 0x0000000000000004ULL, 0x0000000000000400ULL,
+  0x0000000000000401ULL, 0x0000000000040100ULL, 0x0000000000000402ULL,
+  0x0000000000040200ULL, 0x0000000000040201ULL, 0x0000000004020100ULL,
+  0x0000000000000403ULL, 0x0000000000040300ULL, 0x0000000000040301ULL,
+  0x0000000004030100ULL, 0x0000000000040302ULL, 0x0000000004030200ULL,
+  0x0000000004030201ULL, 0x0000000403020100ULL, 0x0000000000000005ULL,
+  0x0000000000000500ULL, 0x0000000000000501ULL, 0x0000000000050100ULL,
+  0x0000000000000502ULL, 0x0000000000050200ULL, 0x0000000000050201ULL,
+  0x0000000005020100ULL, 0x0000000000000503ULL, 0x0000000000050300ULL,
+  0x0000000000050301ULL, 0x0000000005030100ULL, 0x0000000000050302ULL,
+  0x0000000005030200ULL, 0x0000000005030201ULL, 0x0000000503020100ULL,
+  0x0000000000000504ULL, 0x0000000000050400ULL, 0x0000000000050401ULL,
+  0x0000000005040100ULL, 0x0000000000050402ULL, 0x0000000005040200ULL,
+  0x0000000005040201ULL, 0x0000000504020100ULL, 0x0000000000050403ULL,
+  0x0000000005040300ULL, 0x0000000005040301ULL, 0x0000000504030100ULL,
+  0x0000000005040302ULL, 0x0000000504030200ULL, 0x0000000504030201ULL,
+  0x0000050403020100ULL, 0x0000000000000006ULL, 0x0000000000000600ULL,
+  0x0000000000000601ULL, 0x0000000000060100ULL, 0x0000000000000602ULL,
+  0x0000000000060200ULL, 0x0000000000060201ULL, 0x0000000006020100ULL,
+  0x0000000000000603ULL, 0x0000000000060300ULL, 0x0000000000060301ULL,
+  0x0000000006030100ULL, 0x0000000000060302ULL, 0x0000000006030200ULL,
+  0x0000000006030201ULL, 0x0000000603020100ULL, 0x0000000000000604ULL,
+  0x0000000000060400ULL, 0x0000000000060401ULL, 0x0000000006040100ULL,
+  0x0000000000060402ULL, 0x0000000006040200ULL, 0x0000000006040201ULL,
+  0x0000000604020100ULL, 0x0000000000060403ULL, 0x0000000006040300ULL,
+  0x0000000006040301ULL, 0x0000000604030100ULL, 0x0000000006040302ULL,
+  0x0000000604030200ULL, 0x0000000604030201ULL, 0x0000060403020100ULL,
+  0x0000000000000605ULL, 0x0000000000060500ULL, 0x0000000000060501ULL,
+  0x0000000006050100ULL, 0x0000000000060502ULL, 0x0000000006050200ULL,
+  0x0000000006050201ULL, 0x0000000605020100ULL, 0x0000000000060503ULL,
+  0x0000000006050300ULL, 0x0000000006050301ULL, 0x0000000605030100ULL,
+  0x0000000006050302ULL, 0x0000000605030200ULL, 0x0000000605030201ULL,
+  0x0000060503020100ULL, 0x0000000000060504ULL, 0x0000000006050400ULL,
+  0x0000000006050401ULL, 0x0000000605040100ULL, 0x0000000006050402ULL,
+  0x0000000605040200ULL, 0x0000000605040201ULL, 0x0000060504020100ULL,
+  0x0000000006050403ULL, 0x0000000605040300ULL, 0x0000000605040301ULL,
+  0x0000060504030100ULL, 0x0000000605040302ULL, 0x0000060504030200ULL,
+  0x0000060504030201ULL, 0x0006050403020100ULL, 0x0000000000000007ULL,
+  0x0000000000000700ULL, 0x0000000000000701ULL, 0x0000000000070100ULL,
+  0x0000000000000702ULL, 0x0000000000070200ULL, 0x0000000000070201ULL,
+  0x0000000007020100ULL, 0x0000000000000703ULL, 0x0000000000070300ULL,
+  0x0000000000070301ULL, 0x0000000007030100ULL, 0x0000000000070302ULL,
+  0x0000000007030200ULL, 0x0000000007030201ULL, 0x0000000703020100ULL,
+  0x0000000000000704ULL, 0x0000000000070400ULL, 0x0000000000070401ULL,
+  0x0000000007040100ULL, 0x0000000000070402ULL, 0x0000000007040200ULL,
+  0x0000000007040201ULL, 0x0000000704020100ULL, 0x0000000000070403ULL,
+  0x0000000007040300ULL, 0x0000000007040301ULL, 0x0000000704030100ULL,
+  0x0000000007040302ULL, 0x0000000704030200ULL, 0x0000000704030201ULL,
+  0x0000070403020100ULL, 0x0000000000000705ULL, 0x0000000000070500ULL,
+  0x0000000000070501ULL, 0x0000000007050100ULL, 0x0000000000070502ULL,
+  0x0000000007050200ULL, 0x0000000007050201ULL, 0x0000000705020100ULL,
+  0x0000000000070503ULL, 0x0000000007050300ULL, 0x0000000007050301ULL,
+  0x0000000705030100ULL, 0x0000000007050302ULL, 0x0000000705030200ULL,
+  0x0000000705030201ULL, 0x0000070503020100ULL, 0x0000000000070504ULL,
+  0x0000000007050400ULL, 0x0000000007050401ULL, 0x0000000705040100ULL,
+  0x0000000007050402ULL, 0x0000000705040200ULL, 0x0000000705040201ULL,
+  0x0000070504020100ULL, 0x0000000007050403ULL, 0x0000000705040300ULL,
+  0x0000000705040301ULL, 0x0000070504030100ULL, 0x0000000705040302ULL,
+  0x0000070504030200ULL, 0x0000070504030201ULL, 0x0007050403020100ULL,
+  0x0000000000000706ULL, 0x0000000000070600ULL, 0x0000000000070601ULL,
+  0x0000000007060100ULL, 0x0000000000070602ULL, 0x0000000007060200ULL,
+  0x0000000007060201ULL, 0x0000000706020100ULL, 0x0000000000070603ULL,
+  0x0000000007060300ULL, 0x0000000007060301ULL, 0x0000000706030100ULL,
+  0x0000000007060302ULL, 0x0000000706030200ULL, 0x0000000706030201ULL,
+  0x0000070603020100ULL, 0x0000000000070604ULL, 0x0000000007060400ULL,
+  0x0000000007060401ULL, 0x0000000706040100ULL, 0x0000000007060402ULL,
+  0x0000000706040200ULL, 0x0000000706040201ULL, 0x0000070604020100ULL,
+  0x0000000007060403ULL, 0x0000000706040300ULL, 0x0000000706040301ULL,
+  0x0000070604030100ULL, 0x0000000706040302ULL, 0x0000070604030200ULL,
+  0x0000070604030201ULL, 0x0007060403020100ULL, 0x0000000000070605ULL,
+  0x0000000007060500ULL, 0x0000000007060501ULL, 0x0000000706050100ULL,
+  0x0000000007060502ULL, 0x0000000706050200ULL, 0x0000000706050201ULL,
+  0x0000070605020100ULL, 0x0000000007060503ULL, 0x0000000706050300ULL,
+  0x0000000706050301ULL, 0x0000070605030100ULL, 0x0000000706050302ULL,
+  0x0000070605030200ULL, 0x0000070605030201ULL, 0x0007060503020100ULL,
+  0x0000000007060504ULL, 0x0000000706050400ULL, 0x0000000706050401ULL,
+  0x0000070605040100ULL, 0x0000000706050402ULL, 0x0000070605040200ULL,
+  0x0000070605040201ULL, 0x0007060504020100ULL, 0x0000000706050403ULL,
+  0x0000070605040300ULL, 0x0000070605040301ULL, 0x0007060504030100ULL,
+  0x0000070605040302ULL, 0x0007060504030200ULL, 0x0007060504030201ULL,
+  0x0706050403020100ULL
+};
+#endif /* SIMD_X86 */
+
+/*
+ * Find the best kernel the CPU supports: 0: scalar, 1: SSE2, 2: AVX2.
+ * Callers keep it, so that decoding shares nothing among threads.
+ */
+int
+decode_ascii_kernel(void)
+{
+#if SIMD_X86
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2")? 2: 1;
+#else /* SIMD_X86 */
+  return 0;
+#endif /* SIMD_X86 */
+}
+
+/*
+ * Decode leading ASCII bytes of str into characters by kernel, and
+ * returns number of them.  Up to len characters in ostr may be written.
+ */
+size_t
+decode_ascii_run(int kernel, const unsigned char *str, size_t len,
+		 linefold_char *ostr)
+{
+#if SIMD_X86
+  if (kernel == 2)
+    return ascii_run_avx2(str, len, ostr);
+  if (kernel == 1)
+    return ascii_run_sse2(str, len, ostr);
+#endif /* SIMD_X86 */
+  return ascii_run_scalar(str, len, ostr);
+}
+
+/*
+ * Decode leading UTF-8 sequences of one to three bytes in str into
+ * characters by kernel, and returns number of bytes decoded; number of
+ * characters is stored into *olenp.  Sequences of four bytes, illegal
+ * ones and last bytes of str are left to the caller, as are all of them
+ * if kernel isn't AVX2.  Up to len characters in ostr may be written.
+ */
+size_t
+decode_utf8_run(int kernel, const unsigned char *str, size_t len,
+		linefold_char *ostr, size_t *olenp)
+{
+#if SIMD_X86
+  if (kernel == 2)
+    return utf8_run_avx2(str, len, ostr, olenp);
+#endif /* SIMD_X86 */
+  *olenp = 0;
+  return 0;
+}
+
+static size_t
+ascii_run_scalar(const unsigned char *str, size_t len, linefold_char *ostr)
+{
+  size_t i;
+
+  for (i = 0; i < len && str[i] < 0x80; i++)
+    ostr[i] = (linefold_char)str[i];
+  return i;
+}
+
+#if SIMD_X86
+
+/* Characters after the first non-ASCII byte are written but not counted. */
+static size_t
+ascii_run_sse2(const unsigned char *str, size_t len, linefold_char *ostr)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i v, lo, hi;
+  size_t i = 0;
+  int mask;
+
+  while (i + 16 <= len) {
+    v = _mm_loadu_si128((const __m128i *)(str + i));
+    lo = _mm_unpacklo_epi8(v, zero);
+    hi = _mm_unpackhi_epi8(v, zero);
+    _mm_storeu_si128((__m128i *)(ostr + i), _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128((__m128i *)(ostr + i + 4),
+		     _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128((__m128i *)(ostr + i + 8),
+		     _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128((__m128i *)(ostr + i + 12),
+		     _mm_unpackhi_epi16(hi, zero));
+    if ((mask = _mm_movemask_epi8(v)) != 0)
+      return i + __builtin_ctz(mask);
+    i += 16;
+  }
+  return i + ascii_run_scalar(str + i, len - i, ostr + i);
+}
+
+__attribute__((target("avx2")))
+static size_t
+ascii_run_avx2(const unsigned char *str, size_t len, linefold_char *ostr)
+{
+  __m256i v;
+  size_t i = 0;
+  int k;
+  unsigned int mask;
+
+  while (i + 32 <= len) {
+    v = _mm256_loadu_si256((const __m256i *)(str + i));
+    for (k = 0; k < 32; k += 8)
+      _mm256_storeu_si256((__m256i *)(ostr + i + k),
+			  _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)
+							       (str + i + k))));
+    if ((mask = (unsigned int)_mm256_movemask_epi8(v)) != 0)
+      return i + __builtin_ctz(mask);
+    i += 32;
+  }
+  /* Not calling SSE2 kernel, to avoid penalty of mixing encodings. */
+  if (i + 16 <= len) {
+    v = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(str + i)));
+    for (k = 0; k < 16; k += 8)
+      _mm256_storeu_si256((__m256i *)(ostr + i + k),
+			  _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)
+							       (str + i + k))));
+    if ((mask = (unsigned int)_mm256_movemask_epi8(v) & 0xFFFF) != 0)
+      return i + __builtin_ctz(mask);
+    i += 16;
+  }
+  return i + ascii_run_scalar(str + i, len - i, ostr + i);
+}
+
+/*
+ * Characters starting in eight bytes are decoded at once, from sixteen
+ * bytes: Bytes of sequences are classified into masks, so that
+ * continuation bytes are found where leading bytes expect them and
+ * overlong forms and surrogates are rejected; then characters of all
+ * lengths are computed in lanes, and lanes at heads of characters are
+ * gathered.  Each round ends at the end of a character.  Sixteen bytes
+ * of ASCII are widened at once.
+ */
+__attribute__((target("avx2")))
+static size_t
+utf8_run_avx2(const unsigned char *str, size_t len, linefold_char *ostr,
+	      size_t *olenp)
+{
+  const __m128i bias = _mm_set1_epi8((char)0x80);
+  const __m256i mask6 = _mm256_set1_epi32(0x3F);
+  __m128i v, s;
+  __m256i b0, b1, b2, c2, c3;
+  unsigned int hi, geA0, geC0, geC2, geE0, geF0, isE0, isED;
+  unsigned int cont, heads, expected, bad, range;
+  size_t i = 0, o = 0;
+  int last, end;
+
+  while (i + 16 <= len) {
+    v = _mm_loadu_si128((const __m128i *)(str + i));
+    /* Bytes biased by 0x80 are compared as signed. */
+    s = _mm_xor_si128(v, bias);
+    hi = (unsigned int)_mm_movemask_epi8(v);
+    if (hi == 0) {
+      /* Words between sequences are widened at once. */
+      _mm256_storeu_si256((__m256i *)(ostr + o), _mm256_cvtepu8_epi32(v));
+      _mm256_storeu_si256((__m256i *)(ostr + o + 8),
+			  _mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+      o += 16;
+      i += 16;
+      continue;
+    }
+    geA0 = (unsigned int)
+      _mm_movemask_epi8(_mm_cmpgt_epi8(s, _mm_set1_epi8(0x1F)));
+    geC0 = (unsigned int)
+      _mm_movemask_epi8(_mm_cmpgt_epi8(s, _mm_set1_epi8(0x3F)));
+    geC2 = (unsigned int)
+      _mm_movemask_epi8(_mm_cmpgt_epi8(s, _mm_set1_epi8(0x41)));
+    geE0 = (unsigned int)
+      _mm_movemask_epi8(_mm_cmpgt_epi8(s, _mm_set1_epi8(0x5F)));
+    geF0 = (unsigned int)
+      _mm_movemask_epi8(_mm_cmpgt_epi8(s, _mm_set1_epi8(0x6F)));
+    isE0 = (unsigned int)
+      _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xE0)));
+    isED = (unsigned int)
+      _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xED)));
+
+    cont = hi & ~geC0;
+    heads = ~cont & 0xFF;
+    if (!(heads & 1))
+      break;
+    last = 31 - __builtin_clz(heads);
+    end = last + 1 + ((geC0 >> last) & 1) + ((geE0 >> last) & 1);
+    range = (1U << end) - 1;
+    expected = (geC0 << 1) | (geE0 << 2);
+    /* Four bytes, C0, C1, overlong E0 and surrogates of ED. */
+    bad = geF0 | (geC0 & ~geC2) | (isE0 & ~(geA0 >> 1)) |
+      (isED & (geA0 >> 1));
+    if (((cont ^ expected) | bad) & range)
+      break;
+
+    b0 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(str + i)));
+    b1 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)
+					      (str + i + 1)));
+    b2 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)
+					      (str + i + 2)));
+    c2 = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(b0,
+			   _mm256_set1_epi32(0x1F)), 6),
+			 _mm256_and_si256(b1, mask6));
+    c3 = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(b0,
+			   _mm256_set1_epi32(0x0F)), 12),
+			 _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(b1,
+						 mask6), 6),
+					 _mm256_and_si256(b2, mask6)));
+    /* Lanes at leading bytes of two and three bytes are replaced. */
+    c2 = _mm256_blendv_epi8(b0, c2,
+			    _mm256_cmpgt_epi32(b0, _mm256_set1_epi32(0xBF)));
+    c3 = _mm256_blendv_epi8(c2, c3,
+			    _mm256_cmpgt_epi32(b0, _mm256_set1_epi32(0xDF)));
+    c3 = _mm256_permutevar8x32_epi32(c3,
+	   _mm256_cvtepu8_epi32(_mm_cvtsi64_si128((long long)
+						  utf8_compact[heads])));
+    _mm256_storeu_si256((__m256i *)(ostr + o), c3);
+    o += __builtin_popcount(heads);
+    i += end;
+  }
+  *olenp = o;
+  return i;
+}
+
+#endif /* SIMD_X86 */
@@ -20,140 +20,267 @@
 #include "linefold.h"
 
 #define REPLACEMENT_CHARACTER ((linefold_char)0xFFFD)
-static linefold_char SUBST_NARROW = (linefold_char)0x3F; /* QUESTION MARK */
-static linefold_char SUBST_WIDE = (linefold_char)0x3013; /* GETA MARK */
+static const linefold_char SUBST_NARROW = (linefold_char)0x3F; /* QUESTION MARK */
+static const linefold_char SUBST_WIDE = (linefold_char)0x3013; /* GETA MARK */
 
 
-#define EXPAND_BUF(chartype, addlen, extralen)				\
-  clen = op - ostr;							\
-  alloclen += sizeof(chartype)*addlen;					\
-  if ((newostr = (chartype *)malloc(alloclen + extralen)) == NULL) {	\
-    free(ostr);								\
-    return -1;								\
-  }									\
-  memcpy(newostr, ostr, sizeof(chartype) * clen);			\
-  free(ostr);								\
-  ostr = newostr;							\
-  op = ostr + clen;							\
-  oleft += sizeof(chartype)*addlen;
+/* Initial size of conversion buffer. */
+#define ICONV_WRAP_INITSIZE 256
 
+/* Codecs converting without iconv. */
+#define CODEC_ICONV 0
+#define CODEC_UTF8 1
+#define CODEC_UTF16LE 2
+#define CODEC_UTF16BE 3
+#define CODEC_ASCII 4
+#define CODEC_LATIN1 5
+
+static const struct {
+  const char *name;
+  int codec;
+} codec_names[] = {
+  {"UTF-8", CODEC_UTF8},
+  {"UTF-16LE", CODEC_UTF16LE},
+  {"UTF-16BE", CODEC_UTF16BE},
+  {"US-ASCII", CODEC_ASCII},
+  {"ASCII", CODEC_ASCII},
+  {"ANSI_X3.4-1968", CODEC_ASCII},
+  {"ISO-8859-1", CODEC_LATIN1},
+  {"ISO_8859-1", CODEC_LATIN1},
+  {"LATIN1", CODEC_LATIN1},
+  {NULL, CODEC_ICONV}
+};
+
+/* Largest character linefold_char can hold. */
+#define MAX_CHAR ((sizeof(linefold_char) < 4)? 0xFFFFUL: 0x10FFFFUL)
+
+/*
+ * Conversion context: Descriptor is opened at first conversion, and
+ * buffer is reused by following conversions.  Conversions between
+ * Unicode and charsets in codec_names[] are done without iconv.
+ * Conversion touches nothing but its context, so that each thread may
+ * convert by contexts of its own, with any charsets.
+ */
+struct iconv_wrap
+{
+  const char *tocode;
+  const char *fromcode;
+  int codec;                            /* codec of legacy charset */
+  int kernel;                           /* kernel decoding runs of
+					   ASCII and UTF-8 */
+  int intact;                           /* last decoding met no illegal
+					   sequences */
+  int error;                            /* error met after characters
+					   were decoded, reported by next
+					   decoding */
+  iconv_t cd;                           /* descriptor, holding shift
+					   state */
+  char *buf;                            /* conversion buffer */
+  size_t size;                          /* size of buffer */
+};
+
+static int find_codec(const char *);
+static int charsetcmp(const char *, const char *);
+static size_t decode_native(struct iconv_wrap *, char *, size_t *, size_t,
+			    linefold_char **, int);
+static size_t encode_native(struct iconv_wrap *, const struct linefold_info *,
+			    const linefold_char *, size_t, size_t, char **,
+			    int);
+static size_t put_char(int, unsigned long, char *);
+extern int decode_ascii_kernel(void);
+extern size_t decode_ascii_run(int, const unsigned char *, size_t,
+			       linefold_char *);
+extern size_t decode_utf8_run(int, const unsigned char *, size_t,
+			      linefold_char *, size_t *);
+static int open_cd(struct iconv_wrap *);
+static int reserve(struct iconv_wrap *, char **, size_t *, size_t);
+
+
+/*
+ * Allocate conversion context from fromcode to tocode.
+ */
+struct iconv_wrap *iconv_wrap_alloc(const char *tocode, const char *fromcode)
+{
+  struct iconv_wrap *cv;
+
+  if ((cv = (struct iconv_wrap *)malloc(sizeof(struct iconv_wrap))) == NULL)
+    return NULL;
+  cv->tocode = tocode;
+  cv->fromcode = fromcode;
+  cv->codec = CODEC_ICONV;
+  if (charsetcmp(tocode, INTERNAL_LINEFOLD_CHARSET) == 0)
+    cv->codec = find_codec(fromcode);
+  else if (charsetcmp(fromcode, INTERNAL_LINEFOLD_CHARSET) == 0)
+    cv->codec = find_codec(tocode);
+  cv->kernel = decode_ascii_kernel();
+  cv->intact = 1;
+  cv->error = 0;
+  cv->cd = (iconv_t)-1;
+  cv->buf = NULL;
+  cv->size = 0;
+  return cv;
+}
+
+void iconv_wrap_free(struct iconv_wrap *cv)
+{
+  if (cv == NULL)
+    return;
+  if (cv->cd != (iconv_t)-1)
+    iconv_close(cv->cd);
+  free(cv->buf);
+  free(cv);
+}
+
+/*
+ * Whether characters decoded by decoder are encoded by encoder back to
+ * the same bytes, unless illegal sequences were met by decoding.
+ */
+int iconv_wrap_same(const struct iconv_wrap *decoder,
+		    const struct iconv_wrap *encoder)
+{
+  return (decoder->codec != CODEC_ICONV &&
+	  decoder->codec == encoder->codec &&
+	  charsetcmp(decoder->tocode, encoder->fromcode) == 0);
+}
 
 /*
- * Decode string in legacy character set to Unicode string.
+ * Whether context converts without iconv: Its encoding has no shift
+ * state, so that a string is always encoded to the same bytes.
  */
-size_t decode(const char *chset, char *istr, size_t *istartp, size_t ilen,
-              linefold_char **ostrp, size_t ostart, int conversion)
+int iconv_wrap_native(const struct iconv_wrap *cv)
+{
+  return cv->codec != CODEC_ICONV;
+}
+
+/* Whether the last decode() by context met no illegal sequences. */
+int iconv_wrap_intact(const struct iconv_wrap *cv)
 {
-  static iconv_t cd = (iconv_t)-1;
-  static size_t alloclen = 0;
-  char *ip;
-  linefold_char *ostr, *op, *newostr;
-  size_t ileft, oleft, clen;
+  return cv->intact;
+}
 
+/*
+ * Whether the last decode() by context stopped at an error after
+ * characters were decoded: Next decode() reports it.
+ */
+int iconv_wrap_failed(const struct iconv_wrap *cv)
+{
+  return cv->error != 0;
+}
+
+/*
+ * Decode string in legacy character set to Unicode string.  Result is
+ * stored into buffer of context, which is valid until next conversion.
+ * If illegal sequence is met under strict conversion, characters before
+ * it are returned and the error is returned by the next call.
+ */
+size_t decode(struct iconv_wrap *cv, char *istr, size_t *istartp,
+	      size_t ilen, linefold_char **ostrp, int conversion)
+{
+  char *ip, *op;
+  size_t ileft, oleft;
+
+  cv->intact = 1;
+  if (cv->error != 0) {
+    cv->intact = 0;
+    errno = cv->error;
+    cv->error = 0;
+    return -1;
+  }
   if (istr == NULL || ilen == 0)
     return 0;
-
-  if (ostart == 0) {
-    if (cd == (iconv_t)-1 &&
-	(cd = iconv_open(INTERNAL_LINEFOLD_CHARSET, chset)) == (iconv_t)-1)
-      return -1;
-    alloclen = sizeof(linefold_char);
-    if ((ostr = (linefold_char *)malloc(alloclen)) == NULL)
-      return -1;
-  } else
-    ostr = *ostrp;
+  if (cv->codec != CODEC_ICONV)
+    return decode_native(cv, istr, istartp, ilen, ostrp, conversion);
+  if (open_cd(cv) == -1)
+    return -1;
 
   ip = istr + *istartp;
-  op = ostr + ostart;
-  ileft = ilen;
-  oleft = alloclen - sizeof(linefold_char) * ostart;
+  ileft = ilen - *istartp;
+  op = cv->buf;
+  oleft = cv->size;
+  /* Each byte will be decoded to at most one character. */
+  if (reserve(cv, &op, &oleft, sizeof(linefold_char) * (ileft + 1)) == -1)
+    return -1;
 
-  if (istr == NULL) {
-    iconv_close(cd);
-    cd = (iconv_t)-1;
-    *ostrp = ostr;
-    return op - ostr;
-  } else if (ilen == 0) {
-    return 0;
-  } else {
-    while (iconv(cd, &ip, &ileft, (char **)&op, &oleft) == (size_t)-1) {
-      if (errno == E2BIG) {
-	EXPAND_BUF(linefold_char, 1, 0);
-      } else if (errno == EILSEQ) {
-	if (conversion == -1) { /* strict */
-	  return -1;
-	} else if (conversion == 0) { /* ignore */
-	  ip++;
-	  ileft--;
-	} else { /* replace */
-	  if (oleft < sizeof(linefold_char)) {
-	    EXPAND_BUF(linefold_char, 1, 0);
-	  }
-	  ip++;
-	  ileft--;
-	  *(op++) = REPLACEMENT_CHARACTER;
-	  oleft -= sizeof(linefold_char);
-	}
-      } else if (errno == EINVAL) {
-	if (oleft < sizeof(linefold_char)) {
-	  EXPAND_BUF(linefold_char, 1, 0);
+  while (iconv(cv->cd, &ip, &ileft, &op, &oleft) == (size_t)-1) {
+    if (errno == E2BIG) {
+      if (reserve(cv, &op, &oleft, sizeof(linefold_char)) == -1)
+	return -1;
+    } else if (errno == EILSEQ) {
+      if (conversion == -1) { /* strict */
+	if (op != cv->buf) {
+	  cv->error = EILSEQ;
+	  break;
 	}
-	break;
-      } else { /* NOTREACHED */
+	cv->intact = 0;
 	return -1;
       }
+      cv->intact = 0;
+      if (conversion == 0) { /* ignore */
+	ip++;
+	ileft--;
+      } else { /* replace */
+	if (reserve(cv, &op, &oleft, sizeof(linefold_char)) == -1)
+	  return -1;
+	ip++;
+	ileft--;
+	*(linefold_char *)op = REPLACEMENT_CHARACTER;
+	op += sizeof(linefold_char);
+	oleft -= sizeof(linefold_char);
+      }
+    } else if (errno == EINVAL) {
+      break;
+    } else { /* NOTREACHED */
+      return -1;
     }
-
-    *istartp = ip - istr;
-    *ostrp = ostr;
-    return op - ostr;
   }
+
+  *istartp = ip - istr;
+  *ostrp = (linefold_char *)cv->buf;
+  return (op - cv->buf) / sizeof(linefold_char);
 }
 
 /*
- * Encode Unicode string to legacy character set.
+ * Encode Unicode string to legacy character set.  Result terminated by
+ * NUL is stored into buffer of context, which is valid until next
+ * conversion.  If istr is NULL, sequence to return to initial state is
+ * stored.
  */
-size_t encode(const char *chset, const struct linefold_info *lbi,
+size_t encode(struct iconv_wrap *cv, const struct linefold_info *lbi,
 	      const linefold_char *istr, size_t istart, size_t ilen,
 	      char **ostrp, int conversion)
 {
-  static iconv_t cd = (iconv_t)-1;
   const linefold_char *ip;
-  char *ostr, *op, *newostr;
-  size_t alloclen, ileft, oleft, clen;
-
-  if (cd == (iconv_t)-1 &&
-      (cd = iconv_open(chset, INTERNAL_LINEFOLD_CHARSET)) == (iconv_t)-1)
-    return -1;
+  char *op;
+  size_t ileft, oleft;
 
-  alloclen = sizeof(char);
-  if ((ostr = (char *)malloc(alloclen+1)) == NULL)
+  if (cv->codec != CODEC_ICONV)
+    return encode_native(cv, lbi, istr, istart, ilen, ostrp, conversion);
+  if (open_cd(cv) == -1)
     return -1;
 
   ip = istr + istart;
-  op = ostr;
   ileft = ilen * sizeof(linefold_char);
-  oleft = alloclen;
+  op = cv->buf;
+  oleft = cv->size;
 
   if (istr == NULL) {
-    while ((iconv(cd, NULL, NULL, &op, &oleft)) == (size_t)-1) {
+    while ((iconv(cv->cd, NULL, NULL, &op, &oleft)) == (size_t)-1) {
       if (errno == E2BIG) {
-	EXPAND_BUF(char, 1, 1);
+	if (reserve(cv, &op, &oleft, oleft + 1) == -1)
+	  return -1;
       } else { /* NOTREACHED */
 	return -1;
       }
     }
-    iconv_close(cd);
-    cd = (iconv_t)-1;
-    ostr[op - ostr] = '\0';
-    *ostrp = ostr;
-    return op - ostr;
   } else if (ilen == 0) {
     return 0;
   } else {
-    while (iconv(cd, (char **)&ip, &ileft, &op, &oleft) == (size_t)-1) {
+    if (reserve(cv, &op, &oleft, ilen + 1) == -1)
+      return -1;
+    while (iconv(cv->cd, (char **)&ip, &ileft, &op, &oleft) == (size_t)-1) {
       if (errno == E2BIG) {
-	EXPAND_BUF(char, 1, 1);
+	if (reserve(cv, &op, &oleft, oleft + 1) == -1)
+	  return -1;
       } else if (errno == EILSEQ) {
 	if (conversion == -1) { /* strict */
 	  return -1;
@@ -162,17 +289,17 @@ size_t encode(const char *chset, const struct linefold_info *lbi,
 	  ileft -= sizeof(linefold_char);
 	} else { /* replace */
 	  size_t subst_left = sizeof(linefold_char);
-	  linefold_char *subst_str = &SUBST_WIDE;
+	  const linefold_char *subst_str = &SUBST_WIDE;
 
-	  if (oleft < sizeof(char)*7) {
-	    EXPAND_BUF(char, 7, 1);
-	  }
+	  if (reserve(cv, &op, &oleft, 7) == -1)
+	    return -1;
 
-	  if (lbi == NULL || lbi->widths[ip-istr] <= 1 ||
-	      iconv(cd, (char **)&subst_str, &subst_left, &op, &oleft) == -1) {
+	  if (lbi == NULL || LINEFOLD_WIDTH(lbi, ip-istr) <= 1 ||
+	      iconv(cv->cd, (char **)&subst_str, &subst_left, &op, &oleft)
+	      == -1) {
 	    subst_str = &SUBST_NARROW;
-	    if (iconv(cd, (char **)&subst_str, &subst_left, &op, &oleft) ==
-		(size_t)-1) {
+	    if (iconv(cv->cd, (char **)&subst_str, &subst_left, &op, &oleft)
+		== (size_t)-1) {
 	      *(op++) = (char)SUBST_NARROW;
 	      oleft -= sizeof(char);
 	    }
@@ -184,9 +311,403 @@ size_t encode(const char *chset, const struct linefold_info *lbi,
 	return -1;
       }
     }
+  }
+
+  if (reserve(cv, &op, &oleft, 1) == -1)
+    return -1;
+  *op = '\0';
+  *ostrp = cv->buf;
+  return op - cv->buf;
+}
+
+/*
+ * Decode without iconv.  Incomplete sequence at end of input is left as
+ * iconv() does, setting errno to EINVAL.
+ */
+static size_t decode_native(struct iconv_wrap *cv, char *istr,
+			    size_t *istartp, size_t ilen,
+			    linefold_char **ostrp, int conversion)
+{
+  const unsigned char *ip = (unsigned char *)istr + *istartp;
+  const unsigned char *iend = (unsigned char *)istr + ilen;
+  linefold_char *op;
+  char *obuf;
+  size_t oleft, len, n;
+  unsigned long c, c2;
+  int illegal;
 
-    ostr[op - ostr] = '\0';
-    *ostrp = ostr;
-    return op - ostr;
+  obuf = cv->buf;
+  oleft = cv->size;
+  /* Each byte will be decoded to at most one character. */
+  if (reserve(cv, &obuf, &oleft, sizeof(linefold_char) * (iend - ip + 1))
+      == -1)
+    return -1;
+  op = (linefold_char *)cv->buf;
+
+  while (ip < iend) {
+    illegal = 0;
+    len = 1;
+    switch (cv->codec) {
+    case CODEC_UTF8:
+      c = *ip;
+      if (c < 0x80) {
+	/* Run of ASCII. */
+	len = decode_ascii_run(cv->kernel, ip, iend - ip, op);
+	ip += len;
+	op += len;
+	continue;
+      } else if (0xC2 <= c && c < 0xF0 &&
+		 (len = decode_utf8_run(cv->kernel, ip, iend - ip, op, &n))
+		 != 0) {
+	/* Run of sequences of up to three bytes. */
+	ip += len;
+	op += n;
+	continue;
+      } else if (c < 0xC2 || 0xF4 < c) {
+	illegal = 1;
+	break;
+      } else if (c < 0xE0) {
+	len = 2;
+	c &= 0x1F;
+      } else if (c < 0xF0) {
+	len = 3;
+	c &= 0x0F;
+      } else {
+	len = 4;
+	c &= 0x07;
+      }
+      for (c2 = 1; c2 < len; c2++) {
+	if (ip + c2 == iend) {
+	  errno = EINVAL;
+	  goto incomplete;
+	} else if ((ip[c2] & 0xC0) != 0x80) {
+	  illegal = 1;
+	  break;
+	}
+	c = (c << 6) | (ip[c2] & 0x3F);
+	/* Reject overlong forms, surrogates and beyond U+10FFFF as soon
+	   as possible, as they aren't prefixes of valid sequences. */
+	if (c2 == 1 &&
+	    ((len == 3 && c < 0x20) || (len == 3 && 0x360 <= c && c < 0x380) ||
+	     (len == 4 && (c < 0x10 || 0x10F < c)))) {
+	  illegal = 1;
+	  break;
+	}
+      }
+      break;
+    case CODEC_UTF16LE:
+    case CODEC_UTF16BE:
+      len = 2;
+      if (iend - ip < 2) {
+	errno = EINVAL;
+	goto incomplete;
+      }
+      if (cv->codec == CODEC_UTF16LE)
+	c = ip[0] | (ip[1] << 8);
+      else
+	c = (ip[0] << 8) | ip[1];
+      if (0xDC00 <= c && c < 0xE000)
+	illegal = 1;
+      else if (0xD800 <= c && c < 0xDC00) {
+	if (iend - ip < 4) {
+	  errno = EINVAL;
+	  goto incomplete;
+	}
+	if (cv->codec == CODEC_UTF16LE)
+	  c2 = ip[2] | (ip[3] << 8);
+	else
+	  c2 = (ip[2] << 8) | ip[3];
+	if (c2 < 0xDC00 || 0xE000 <= c2)
+	  illegal = 1;
+	else {
+	  len = 4;
+	  c = 0x10000 + ((c - 0xD800) << 10) + (c2 - 0xDC00);
+	}
+      }
+      break;
+    case CODEC_ASCII:
+      if ((len = decode_ascii_run(cv->kernel, ip, iend - ip, op)) != 0) {
+	ip += len;
+	op += len;
+	continue;
+      }
+      c = *ip;
+      illegal = 1;
+      break;
+    default: /* CODEC_LATIN1 */
+      c = *ip;
+      break;
+    }
+    if (!illegal && MAX_CHAR < c)
+      illegal = 1;
+
+    if (!illegal) {
+      *(op++) = (linefold_char)c;
+      ip += len;
+      continue;
+    }
+    if (conversion == -1) { /* strict */
+      if (op != (linefold_char *)cv->buf) {
+	cv->error = EILSEQ;
+	goto incomplete;
+      }
+      cv->intact = 0;
+      errno = EILSEQ;
+      return -1;
+    }
+    /* Skip a byte, or a unit of UTF-16. */
+    cv->intact = 0;
+    if (conversion != 0) /* replace */
+      *(op++) = REPLACEMENT_CHARACTER;
+    ip += (cv->codec == CODEC_UTF16LE || cv->codec == CODEC_UTF16BE)? 2: 1;
+  }
+
+ incomplete:
+  *istartp = (char *)ip - istr;
+  *ostrp = (linefold_char *)cv->buf;
+  return op - (linefold_char *)cv->buf;
+}
+
+/*
+ * Encode without iconv.  Characters which can't be encoded are replaced
+ * in the same way as encode() does.
+ */
+static size_t encode_native(struct iconv_wrap *cv,
+			    const struct linefold_info *lbi,
+			    const linefold_char *istr, size_t istart,
+			    size_t ilen, char **ostrp, int conversion)
+{
+  const linefold_char *ip, *iend;
+  char *op;
+  size_t oleft, len;
+  unsigned long c;
+
+  if (istr == NULL)
+    ilen = 0;
+  else if (ilen == 0)
+    return 0;
+
+  op = cv->buf;
+  oleft = cv->size;
+  /* Each character will be encoded to at most 4 bytes. */
+  if (reserve(cv, &op, &oleft, 4 * ilen + 1) == -1)
+    return -1;
+
+  for (ip = istr + istart, iend = ip + ilen; ip < iend; ip++) {
+    c = (unsigned long)*ip;
+    if (c < 0x80 && cv->codec != CODEC_UTF16LE &&
+	cv->codec != CODEC_UTF16BE) {
+      *(op++) = (char)c;
+      continue;
+    }
+    if ((len = put_char(cv->codec, c, op)) != 0) {
+      op += len;
+      continue;
+    }
+
+    if (conversion == -1) { /* strict */
+      errno = EILSEQ;
+      return -1;
+    } else if (conversion != 0) { /* replace */
+      len = 0;
+      if (lbi != NULL && LINEFOLD_WIDTH(lbi, ip-istr) > 1)
+	len = put_char(cv->codec, (unsigned long)SUBST_WIDE, op);
+      if (len == 0)
+	len = put_char(cv->codec, (unsigned long)SUBST_NARROW, op);
+      op += len;
+    }
+  }
+
+  *op = '\0';
+  *ostrp = cv->buf;
+  return op - cv->buf;
+}
+
+/*
+ * Length of bytes encode() would store, for contexts without iconv.
+ * Returns -1 if encoding would fail.
+ */
+size_t encoded_length(struct iconv_wrap *cv,
+		      const struct linefold_info *lbi,
+		      const linefold_char *istr, size_t istart, size_t ilen,
+		      int conversion)
+{
+  const linefold_char *ip, *iend;
+  char tmp[4];
+  size_t olen = 0, len;
+  unsigned long c;
+
+  if (cv->codec == CODEC_ICONV) {
+    errno = EINVAL;
+    return -1;
+  }
+  for (ip = istr + istart, iend = ip + ilen; ip < iend; ip++) {
+    c = (unsigned long)*ip;
+    if (c < 0x80 && cv->codec != CODEC_UTF16LE &&
+	cv->codec != CODEC_UTF16BE) {
+      olen++;
+      continue;
+    }
+    if ((len = put_char(cv->codec, c, tmp)) != 0) {
+      olen += len;
+      continue;
+    }
+
+    if (conversion == -1) { /* strict */
+      errno = EILSEQ;
+      return -1;
+    } else if (conversion != 0) { /* replace */
+      len = 0;
+      if (lbi != NULL && LINEFOLD_WIDTH(lbi, ip-istr) > 1)
+	len = put_char(cv->codec, (unsigned long)SUBST_WIDE, tmp);
+      if (len == 0)
+	len = put_char(cv->codec, (unsigned long)SUBST_NARROW, tmp);
+      olen += len;
+    }
   }
+  return olen;
+}
+
+/*
+ * Encode a character into buf by codec.  Returns length of encoded
+ * sequence, or 0 if the character can't be encoded.
+ */
+static size_t put_char(int codec, unsigned long c, char *buf)
+{
+  unsigned char *p = (unsigned char *)buf;
+
+  if ((0xD800 <= c && c < 0xE000) || 0x10FFFF < c)
+    return 0;
+
+  switch (codec) {
+  case CODEC_UTF8:
+    if (c < 0x80) {
+      p[0] = c;
+      return 1;
+    } else if (c < 0x800) {
+      p[0] = 0xC0 | (c >> 6);
+      p[1] = 0x80 | (c & 0x3F);
+      return 2;
+    } else if (c < 0x10000) {
+      p[0] = 0xE0 | (c >> 12);
+      p[1] = 0x80 | ((c >> 6) & 0x3F);
+      p[2] = 0x80 | (c & 0x3F);
+      return 3;
+    }
+    p[0] = 0xF0 | (c >> 18);
+    p[1] = 0x80 | ((c >> 12) & 0x3F);
+    p[2] = 0x80 | ((c >> 6) & 0x3F);
+    p[3] = 0x80 | (c & 0x3F);
+    return 4;
+  case CODEC_UTF16LE:
+  case CODEC_UTF16BE:
+    if (c < 0x10000) {
+      if (codec == CODEC_UTF16LE) {
+	p[0] = c & 0xFF;
+	p[1] = c >> 8;
+      } else {
+	p[0] = c >> 8;
+	p[1] = c & 0xFF;
+      }
+      return 2;
+    }
+    c -= 0x10000;
+    if (codec == CODEC_UTF16LE) {
+      p[0] = (c >> 10) & 0xFF;
+      p[1] = 0xD8 | (c >> 18);
+      p[2] = c & 0xFF;
+      p[3] = 0xDC | ((c >> 8) & 0x03);
+    } else {
+      p[0] = 0xD8 | (c >> 18);
+      p[1] = (c >> 10) & 0xFF;
+      p[2] = 0xDC | ((c >> 8) & 0x03);
+      p[3] = c & 0xFF;
+    }
+    return 4;
+  case CODEC_ASCII:
+    if (0x80 <= c)
+      return 0;
+    p[0] = c;
+    return 1;
+  default: /* CODEC_LATIN1 */
+    if (0x100 <= c)
+      return 0;
+    p[0] = c;
+    return 1;
+  }
+}
+
+/* Find codec converting charset without iconv. */
+static int find_codec(const char *chset)
+{
+  int i;
+
+  if (chset == NULL)
+    return CODEC_ICONV;
+  for (i = 0; codec_names[i].name != NULL; i++)
+    if (charsetcmp(chset, codec_names[i].name) == 0)
+      return codec_names[i].codec;
+  return CODEC_ICONV;
+}
+
+/*
+ * Compare names of charsets ignoring case and non-alphanumeric
+ * characters.
+ */
+static int charsetcmp(const char *s1, const char *s2)
+{
+  unsigned char c1, c2;
+
+  if (s1 == NULL || s2 == NULL)
+    return -1;
+  for (;;) {
+    while ((c1 = (unsigned char)*s1) && !('0' <= c1 && c1 <= '9') &&
+	   !('A' <= c1 && c1 <= 'Z') && !('a' <= c1 && c1 <= 'z'))
+      s1++;
+    while ((c2 = (unsigned char)*s2) && !('0' <= c2 && c2 <= '9') &&
+	   !('A' <= c2 && c2 <= 'Z') && !('a' <= c2 && c2 <= 'z'))
+      s2++;
+    if ('a' <= c1 && c1 <= 'z')
+      c1 -= 'a'-'A';
+    if ('a' <= c2 && c2 <= 'z')
+      c2 -= 'a'-'A';
+    if (c1 != c2 || c1 == '\0')
+      return c1 - c2;
+    s1++;
+    s2++;
+  }
+}
+
+/* Open conversion descriptor of context if it has not been opened. */
+static int open_cd(struct iconv_wrap *cv)
+{
+  if (cv->cd == (iconv_t)-1 &&
+      (cv->cd = iconv_open(cv->tocode, cv->fromcode)) == (iconv_t)-1)
+    return -1;
+  return 0;
+}
+
+/*
+ * Grow buffer of context so that at least len bytes are left after
+ * output pointer *opp.  Size is doubled, so that converting long string
+ * takes linear time.  *opp and *oleftp are updated.
+ */
+static int reserve(struct iconv_wrap *cv, char **opp, size_t *oleftp,
+		   size_t len)
+{
+  size_t used = cv->buf? *opp - cv->buf: 0, size;
+  char *buf;
+
+  if (cv->buf != NULL && len <= *oleftp)
+    return 0;
+  size = cv->size? cv->size: ICONV_WRAP_INITSIZE;
+  while (size - used < len)
+    size *= 2;
+  if ((buf = (char *)realloc(cv->buf, size)) == NULL)
+    return -1;
+  cv->buf = buf;
+  cv->size = size;
+  *opp = buf + used;
+  *oleftp = size - used;
+  return 0;
 }
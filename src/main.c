@@ -19,11 +19,37 @@
 #include "common.h"
 #include "linefold.h"
 
+#if HAVE_UNISTD_H
+#    include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+/* Regular files are mapped into memory instead of being read. */
+#if HAVE_MMAP && HAVE_SYS_MMAN_H && HAVE_SYS_STAT_H
+#    define USE_MMAP 1
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#endif
+
+struct iconv_wrap;
+extern struct iconv_wrap *
+iconv_wrap_alloc(const char *, const char *);
+extern void
+iconv_wrap_free(struct iconv_wrap *);
+extern size_t
+decode(struct iconv_wrap *, char *, size_t *, size_t, linefold_char **, int);
 extern size_t
-decode(const char *, char *, size_t *, size_t, linefold_char **, size_t, int);
+encode(struct iconv_wrap *, const struct linefold_info *,
+       const linefold_char *, size_t, size_t, char **, int);
 extern size_t
-encode(const char *, const struct linefold_info *, const linefold_char *,
-       size_t, size_t, char **, int);
+encoded_length(struct iconv_wrap *, const struct linefold_info *,
+	       const linefold_char *, size_t, size_t, int);
+extern int
+iconv_wrap_same(const struct iconv_wrap *, const struct iconv_wrap *);
+extern int
+iconv_wrap_intact(const struct iconv_wrap *);
+extern int
+iconv_wrap_failed(const struct iconv_wrap *);
+extern int
+iconv_wrap_native(const struct iconv_wrap *);
 extern void
 usage(char **);
 extern int
@@ -38,6 +64,7 @@ extern char *option_context_code;
 extern int option_conversion;
 extern char *option_from_code;
 extern int option_help;
+extern int option_jobs;
 /* extern linefold_char *option_line_starter;
    extern size_t option_line_starter_len; */
 extern linefold_char *option_line_terminator;
@@ -50,6 +77,7 @@ FILE *option_output_fp;
 extern linefold_char *option_paragraph_terminator;
 extern size_t option_paragraph_terminator_len;
 extern int option_nostrip_eof;
+extern int option_pipeline;
 /* extern linefold_char *option_text_starter;
    extern size_t option_text_starter_len; */
 extern linefold_char *option_text_terminator;
@@ -59,34 +87,190 @@ extern int option_notrim_sp;
 extern int option_version;
 
 
+/* Initial size of buffer of output context. */
+#define OUTPUT_INITSIZE 4096
+/* Size of output buffer, written out when it is full. */
+#define OUTPUT_BUFSIZE 65536
+/* Number of bytes of input decoded at once. */
+#define INPUT_BLOCKSIZE 65536
+/* Number of blocks each queue of pipeline holds. */
+#define PIPELINE_SLOTS 8
+/* Step to touch pages of mapped input. */
+#define PIPELINE_PAGESIZE 4096
+
+/* Terminator encoded in advance. */
+struct encoded
+{
+  char *str;                            /* NULL if not encoded */
+  size_t len;
+};
+
+/*
+ * Output context passed to writeout_cb().  If input is written as is,
+ * bytes of characters fed into stream are kept from start to len of buf
+ * until they are written out.  Output is gathered into obuf.
+ */
+struct output
+{
+  struct iconv_wrap *encoder;
+  int verbatim;
+  char *buf;
+  size_t start, len, size;
+  char *obuf;
+  size_t olen;
+  struct queue *queue;                  /* queue to writer thread, or
+					   NULL */
+  struct encoded line_terminator;
+  struct encoded paragraph_terminator;
+  struct encoded text_terminator;
+};
+
+/* Output context whose buffer is written out on error. */
+static struct output *current_output = NULL;
+
+#if USE_PTHREAD
+
+/* Kinds of blocks passed between stages of pipeline. */
+#define BLOCK_DATA 0
+#define BLOCK_EOF 1                     /* end of an input file */
+#define BLOCK_END 2                     /* end of all input */
+#define BLOCK_ERROR 3
+
+/*
+ * Block passed from a stage of pipeline to the next.  Buffers belong to
+ * the slot holding it, and are reused by following blocks.
+ */
+struct block
+{
+  int kind;
+  const char *data;                     /* bytes read: bytes, or part of
+					   mapped file */
+  char *bytes;                          /* bytes read, decoded or to be
+					   written out */
+  size_t len, size;
+  linefold_char *text;                  /* decoded characters */
+  size_t textlen, textsize;
+  int intact;                           /* bytes were decoded without
+					   illegal sequences */
+  char *map;                            /* mapped file ended by
+					   BLOCK_EOF, or NULL */
+  size_t maplen;
+  int errnum;                           /* error of BLOCK_ERROR */
+  const char *msg;
+};
+
+/*
+ * Queue of blocks from a stage to the next.  The producer waits while
+ * it is full, and the consumer waits while it is empty.
+ */
+struct queue
+{
+  struct block slots[PIPELINE_SLOTS];
+  size_t head, tail;                    /* numbers of blocks taken and put
+					   so far */
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+};
+
+/*
+ * Pipeline: A reader thread reads files, a decoder thread decodes them,
+ * the main thread folds lines by stream and a writer thread writes them
+ * out.  An error in a stage is passed down as a block, so that output
+ * before it is written out.
+ */
+struct pipeline
+{
+  struct queue input;                   /* from reader to decoder */
+  struct queue decoded;                 /* from decoder to folder */
+  struct queue output;                  /* from folder to writer */
+  char **files;
+  int nfiles;
+  struct iconv_wrap *decoder;           /* used by decoder thread only */
+  struct output *out;                   /* used by folder only, with its
+					   encoder */
+  pthread_t writer;
+  int failed;                           /* folder has met an error */
+};
+
+/* Pipeline running, whose stages pass errors down. */
+static struct pipeline *current_pipeline = NULL;
+/* Queue each stage puts blocks into. */
+static pthread_key_t stage_key;
+
+#endif /* USE_PTHREAD */
+
 void error_exit(int, const char *);
+void feed_text(struct linefold_stream *, const linefold_char *, size_t,
+	       size_t *);
+size_t feed_bytes(struct linefold_stream *, struct iconv_wrap *,
+		  struct output *, char *, size_t, size_t *);
+size_t decode_bytes(struct iconv_wrap *, char *, size_t *, size_t,
+		    linefold_char **);
+void feed_decoded(struct linefold_stream *, struct output *, const char *,
+		  size_t, const linefold_char *, size_t, int, size_t *);
+void end_of_file(struct output *, size_t *);
+size_t read_block(char *, size_t, FILE *);
+char *map_input(FILE *, size_t *);
+FILE *open_input(const char *);
+void fold_files(struct linefold_stream *, struct iconv_wrap *,
+		struct output *, char **, int);
+void keep_bytes(struct output *, const char *, size_t);
+const char *take_bytes(struct output *, const linefold_char *, size_t,
+		       size_t, size_t *);
+void write_bytes(struct output *, const char *, size_t);
+void write_out(struct output *, const char *, size_t);
+void flush_output(struct output *);
+void encode_terminator(struct output *, const linefold_char *, size_t,
+		       struct encoded *);
+size_t get_terminator(struct output *, const linefold_char *, size_t,
+		      const struct encoded *, char **);
+#if USE_PTHREAD
+int fold_pipelined(struct linefold_stream *, struct iconv_wrap *,
+		   struct output *, char **, int);
+void fold_stage(struct pipeline *, struct linefold_stream *);
+void *read_stage(void *);
+void *decode_stage(void *);
+void *write_stage(void *);
+void pipeline_fail(struct pipeline *, int, const char *);
+int queue_init(struct queue *);
+void queue_destroy(struct queue *);
+struct block *queue_reserve(struct queue *);
+void queue_put(struct queue *);
+void queue_put_kind(struct queue *, int, int, const char *);
+struct block *queue_get(struct queue *);
+struct block *queue_poll(struct queue *);
+void queue_release(struct queue *);
+void *grow_buffer(void *, size_t *, size_t, size_t);
+#endif /* USE_PTHREAD */
 
 /*
  * Customizable Functions for line breaking module.
  */
 
-/* Write out one broken line */
+/* Write out one broken line, encoded by output context voidarg */
 void
 writeout_cb(const struct linefold_info *lbinfo,
 	    const linefold_char * text,
 	    size_t start, size_t linelen, linefold_action action,
 	    void *voidarg)
 {
+  struct output *output = voidarg;
+  struct iconv_wrap *encoder = output->encoder;
   char *str = NULL;
-  size_t nlseqstart, nlseqlen, len;
-  const linefold_class *lbclasses = lbinfo->lbclasses;
+  const char *nlseq = NULL;
+  size_t nlseqstart, nlseqlen, nlseqbytes = 0, len;
   linefold_class lbc;
 
   nlseqlen = 0;
   nlseqstart = start + linelen;
-  lbc = lbclasses[nlseqstart - 1];
+  lbc = LINEFOLD_LBCLASS(lbinfo, nlseqstart - 1);
   if (nlseqstart > start) {
     if (lbc == LINEFOLD_CLASS_LF || lbc == LINEFOLD_CLASS_CR) {
       linelen--;
       nlseqstart--;
       nlseqlen++;
       while (nlseqstart > start &&
-	     lbclasses[nlseqstart - 1] == LINEFOLD_CLASS_CR) {
+	     LINEFOLD_LBCLASS(lbinfo, nlseqstart - 1) == LINEFOLD_CLASS_CR) {
 	linelen--;
 	nlseqstart--;
 	nlseqlen++;
@@ -99,81 +283,80 @@ writeout_cb(const struct linefold_info *lbinfo,
   }
   if (!option_notrim_sp)
     while (linelen > 0)
-      if (lbclasses[start + linelen - 1] == LINEFOLD_CLASS_SP)
+      if (LINEFOLD_LBCLASS(lbinfo, start + linelen - 1) == LINEFOLD_CLASS_SP)
 	linelen--;
       else
 	break;
 
-  if ((len = encode(option_to_code, lbinfo, text, start, linelen,
-		    &str, option_conversion)) == -1)
+  if (output->verbatim) {
+    /* Input bytes are written instead of encoding characters. */
+    const char *bytes = take_bytes(output, text, start, linelen, &len);
+
+    write_bytes(output, bytes, len);
+    /* Trimmed spaces. */
+    take_bytes(output, text, start + linelen,
+	       nlseqstart - (start + linelen), &len);
+    nlseq = take_bytes(output, text, nlseqstart, nlseqlen, &nlseqbytes);
+  } else if ((len = encode(encoder, lbinfo, text, start, linelen,
+			   &str, option_conversion)) == -1)
     error_exit(errno,
 	       (errno == EINVAL) ?
 	       "Unsupported character set for output" : NULL);
 
   if (str != NULL) {
-    if (len > 0)
-      fwrite(str, len, 1, option_output_fp);
-    free(str);
+    write_bytes(output, str, len);
     str = NULL;
   }
 
   if (action == LINEFOLD_ACTION_EXPLICIT) {
     if (option_paragraph_terminator) {
-      if ((len = encode(option_to_code, NULL,
-			option_paragraph_terminator,
-			0, option_paragraph_terminator_len,
-			&str, option_conversion)) == -1)
-	error_exit(errno, NULL);
+      len = get_terminator(output, option_paragraph_terminator,
+			   option_paragraph_terminator_len,
+			   &output->paragraph_terminator, &str);
+    } else if (nlseq != NULL) {
+      write_bytes(output, nlseq, nlseqbytes);
     } else {
-      if ((len = encode(option_to_code, lbinfo,
+      if ((len = encode(encoder, lbinfo,
 			text, nlseqstart, nlseqlen,
 			&str, option_conversion)) == -1)
 	error_exit(errno, NULL);
     }
 
     if (str != NULL) {
-      if (len > 0)
-	fwrite(str, len, 1, option_output_fp);
-      free(str);
+      write_bytes(output, str, len);
       str = NULL;
     }
   } else if (action == LINEFOLD_ACTION_DIRECT ||
 	     action == LINEFOLD_ACTION_INDIRECT) {
-    if ((len = encode(option_to_code, NULL,
-		      option_line_terminator, 0, option_line_terminator_len,
-		      &str, option_conversion)) == -1)
-      error_exit(errno, NULL);
-    fwrite(str, len, 1, option_output_fp);
-    free(str);
+    len = get_terminator(output, option_line_terminator,
+			 option_line_terminator_len,
+			 &output->line_terminator, &str);
+    write_bytes(output, str, len);
   } else if (LINEFOLD_ACTION_EOT) {
     if (option_text_terminator) {
-      if ((len = encode(option_to_code, NULL,
-			option_text_terminator, 0, option_text_terminator_len,
-			&str, option_conversion)) == -1)
-	error_exit(errno, NULL);
+      len = get_terminator(output, option_text_terminator,
+			   option_text_terminator_len,
+			   &output->text_terminator, &str);
+    } else if (nlseq != NULL) {
+      write_bytes(output, nlseq, nlseqbytes);
     } else if (nlseqlen) {
-      if ((len = encode(option_to_code, lbinfo,
+      if ((len = encode(encoder, lbinfo,
 			text, nlseqstart, nlseqlen,
 			&str, option_conversion)) == -1)
 	error_exit(errno, NULL);
     }
 
     if (str != NULL) {
-      if (len > 0)
-	fwrite(str, len, 1, option_output_fp);
-      free(str);
+      write_bytes(output, str, len);
       str = NULL;
     }
 
 
-    if ((len = encode(option_to_code, NULL,
+    if ((len = encode(encoder, NULL,
 		      NULL, 0, 0, &str, option_conversion)) == -1)
       error_exit(errno, NULL);
-    if (str != NULL) {
-      if (len > 0)
-	fwrite(str, len, 1, option_output_fp);
-      free(str);
-    }
+    if (str != NULL)
+      write_bytes(output, str, len);
   }
 }
 
@@ -204,6 +387,19 @@ version(void)
 void
 error_exit(int errnum, const char *msg)
 {
+  struct output *output = current_output;
+
+#if USE_PTHREAD
+  /* Stages but writer pass error down and don't return. */
+  if (current_pipeline != NULL)
+    pipeline_fail(current_pipeline, errnum, msg);
+#endif /* USE_PTHREAD */
+
+  /* Write out lines folded so far, only once even if writing fails. */
+  current_output = NULL;
+  if (output != NULL)
+    flush_output(output);
+
   errno = 0;
   if (msg == NULL) {
     msg = strerror(errnum);
@@ -216,14 +412,790 @@ error_exit(int errnum, const char *msg)
   exit(errnum ? errnum : 255);
 }
 
-int
-main(int argc, char **argv)
+/*
+ * Feed decoded text into stream.  EOFs at end of text are not fed but
+ * counted by neofp, since they may be at end of file: Ones counted
+ * before are fed prior to text.
+ */
+void
+feed_text(struct linefold_stream *stream, const linefold_char *text,
+	  size_t textlen, size_t *neofp)
+{
+  static const linefold_char eof = (linefold_char) 0x001A;
+  size_t len = textlen;
+
+  if (!option_nostrip_eof)
+    while (len > 0 && text[len - 1] == eof)
+      len--;
+  if (len == 0) {
+    *neofp += textlen;
+    return;
+  }
+
+  for (; *neofp > 0; (*neofp)--)
+    if (linefold_stream_feed(stream, &eof, 1) != 0)
+      error_exit(errno, NULL);
+  if (linefold_stream_feed(stream, text, len) != 0)
+    error_exit(errno, NULL);
+  *neofp = textlen - len;
+}
+
+/*
+ * Keep len bytes of str, which will be fed into stream as characters.
+ */
+void
+keep_bytes(struct output *output, const char *str, size_t len)
+{
+  size_t size;
+  char *buf;
+
+  /* Discard bytes already written, then grow buffer by doubling. */
+  if (output->start > 0 && output->size - output->len < len) {
+    memmove(output->buf, output->buf + output->start,
+	    output->len - output->start);
+    output->len -= output->start;
+    output->start = 0;
+  }
+  if (output->size - output->len < len) {
+    size = output->size? output->size: OUTPUT_INITSIZE;
+    while (size - output->len < len)
+      size *= 2;
+    if ((buf = realloc(output->buf, size)) == NULL)
+      error_exit(errno, NULL);
+    output->buf = buf;
+    output->size = size;
+  }
+  memcpy(output->buf + output->len, str, len);
+  output->len += len;
+}
+
+/*
+ * Take kept bytes of len characters from start of text, which must be
+ * the first ones not taken yet.  Returns pointer to them, storing their
+ * length into lenp.
+ */
+const char *
+take_bytes(struct output *output, const linefold_char *text, size_t start,
+	   size_t len, size_t *lenp)
+{
+  const char *bytes = output->buf + output->start;
+
+  /* Bytes not from input were encoded by encode() without line breaking
+     informations: Count them in the same way. */
+  if ((*lenp = encoded_length(output->encoder, NULL, text, start, len,
+			      option_conversion)) == -1)
+    error_exit(errno, NULL);
+  output->start += *lenp;
+  return bytes;
+}
+
+/*
+ * Append len bytes of str to output buffer, writing out the buffer when
+ * it is full.  Longer string is written out directly.
+ */
+void
+write_bytes(struct output *output, const char *str, size_t len)
+{
+  if (len == 0)
+    return;
+  if (OUTPUT_BUFSIZE - output->olen < len) {
+    flush_output(output);
+    if (OUTPUT_BUFSIZE < len) {
+      write_out(output, str, len);
+      return;
+    }
+  }
+  memcpy(output->obuf + output->olen, str, len);
+  output->olen += len;
+}
+
+/* Write out len bytes of str, or pass them to writer thread. */
+void
+write_out(struct output *output, const char *str, size_t len)
+{
+#if USE_PTHREAD
+  struct block *block;
+
+  if (output->queue != NULL) {
+    block = queue_reserve(output->queue);
+    if ((block->bytes = grow_buffer(block->bytes, &block->size, len, 1))
+	== NULL)
+      error_exit(errno, NULL);
+    memcpy(block->bytes, str, len);
+    block->len = len;
+    block->kind = BLOCK_DATA;
+    queue_put(output->queue);
+    return;
+  }
+#endif /* USE_PTHREAD */
+  if (fwrite(str, len, 1, option_output_fp) != 1)
+    error_exit(errno, NULL);
+}
+
+/* Write out output buffer.  Writer thread flushes file by itself. */
+void
+flush_output(struct output *output)
+{
+  if (output->olen > 0)
+    write_out(output, output->obuf, output->olen);
+  output->olen = 0;
+  if (output->queue == NULL)
+    fflush(option_output_fp);
+}
+
+/*
+ * Encode terminator in advance, if encoder always encodes it to the
+ * same bytes.
+ */
+void
+encode_terminator(struct output *output, const linefold_char *text,
+		  size_t len, struct encoded *encoded)
+{
+  char *str;
+
+  encoded->str = NULL;
+  encoded->len = 0;
+  if (text == NULL || len == 0 || !iconv_wrap_native(output->encoder))
+    return;
+  if ((len = encode(output->encoder, NULL, text, 0, len, &str,
+		    option_conversion)) == -1)
+    error_exit(errno, NULL);
+  if ((encoded->str = malloc(len + 1)) == NULL)
+    error_exit(errno, NULL);
+  memcpy(encoded->str, str, len + 1);
+  encoded->len = len;
+}
+
+/* Get encoded terminator, encoding it if it wasn't in advance. */
+size_t
+get_terminator(struct output *output, const linefold_char *text,
+	       size_t len, const struct encoded *encoded, char **strp)
+{
+  if (encoded->str != NULL) {
+    *strp = encoded->str;
+    return encoded->len;
+  }
+  if ((len = encode(output->encoder, NULL, text, 0, len, strp,
+		    option_conversion)) == -1)
+    error_exit(errno, NULL);
+  return len;
+}
+
+/*
+ * Decode len bytes of str and feed them into stream.  Returns number of
+ * bytes decoded: Incomplete sequence at end is left.  Text before an
+ * illegal sequence is fed before the error is reported.
+ */
+size_t
+feed_bytes(struct linefold_stream *stream, struct iconv_wrap *decoder,
+	   struct output *output, char *str, size_t len, size_t *neofp)
 {
   linefold_char *text = NULL;
-  size_t textlen = 0;
+  size_t textlen, pos = 0;
+
+  if ((textlen = decode_bytes(decoder, str, &pos, len, &text)) != 0)
+    feed_decoded(stream, output, str, pos, text, textlen,
+		 iconv_wrap_intact(decoder), neofp);
+  if (iconv_wrap_failed(decoder))
+    decode_bytes(decoder, str, &pos, len, &text);
+  return pos;
+}
+
+/*
+ * Decode bytes of str from *posp to len.  Returns number of characters
+ * stored into *textp, updating *posp past bytes decoded.
+ */
+size_t
+decode_bytes(struct iconv_wrap *decoder, char *str, size_t *posp,
+	     size_t len, linefold_char **textp)
+{
+  size_t textlen;
+
+  if ((textlen = decode(decoder, str, posp, len,
+			textp, option_conversion)) == -1)
+    error_exit(errno,
+	       (errno == EINVAL) ?
+	       "Unsupported character set for input" : NULL);
+  return textlen;
+}
+
+/*
+ * Feed textlen characters decoded from len bytes of str into stream.
+ * intact tells whether decoding met no illegal sequences.
+ */
+void
+feed_decoded(struct linefold_stream *stream, struct output *output,
+	     const char *str, size_t len, const linefold_char *text,
+	     size_t textlen, int intact, size_t *neofp)
+{
+  /* Bytes of characters are kept until they are written out: Input
+     itself unless it had illegal sequences. */
+  if (output->verbatim) {
+    if (intact)
+      keep_bytes(output, str, len);
+    else {
+      char *ostr;
+      size_t olen;
+
+      if ((olen = encode(output->encoder, NULL, text, 0, textlen, &ostr,
+			 option_conversion)) == -1)
+	error_exit(errno, NULL);
+      keep_bytes(output, ostr, olen);
+    }
+  }
+
+  feed_text(stream, text, textlen, neofp);
+}
+
+/* Finish an input file: Kept bytes of EOFs trimmed at its end are
+   dropped. */
+void
+end_of_file(struct output *output, size_t *neofp)
+{
+  static const linefold_char eof = (linefold_char) 0x001A;
+
+  if (output->verbatim && *neofp > 0)
+    output->len -= *neofp * encoded_length(output->encoder, NULL, &eof, 0, 1,
+					   option_conversion);
+  *neofp = 0;
+}
+
+/*
+ * Read at most size bytes.  Unlike fread(), pipes and terminals give
+ * bytes as soon as they are available, so that lines are folded as they
+ * arrive.  Returns number of bytes read, or 0 at end of file.
+ */
+size_t
+read_block(char *buf, size_t size, FILE *fp)
+{
+#if HAVE_UNISTD_H
+  ssize_t len;
+
+  while ((len = read(fileno(fp), buf, size)) == -1 && errno == EINTR)
+    ;
+  if (len == -1)
+    error_exit(errno, NULL);
+  return len;
+#else /* HAVE_UNISTD_H */
+  size_t len = fread(buf, 1, size, fp);
+
+  if (len == 0 && ferror(fp))
+    error_exit(errno, NULL);
+  return len;
+#endif /* HAVE_UNISTD_H */
+}
+
+/*
+ * Map whole of input into memory.  Returns NULL if it isn't a regular
+ * file or can't be mapped.
+ */
+char *
+map_input(FILE *fp, size_t *lenp)
+{
+#if USE_MMAP
+  struct stat st;
+  void *map;
+
+  if (fstat(fileno(fp), &st) != 0 || !S_ISREG(st.st_mode) ||
+      st.st_size <= 0 || (off_t)(size_t)st.st_size != st.st_size)
+    return NULL;
+  if ((map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+		  fileno(fp), 0)) == MAP_FAILED)
+    return NULL;
+  *lenp = (size_t)st.st_size;
+  return map;
+#else /* USE_MMAP */
+  return NULL;
+#endif /* USE_MMAP */
+}
+
+/* Open input file, or standard input if name is `-'. */
+FILE *
+open_input(const char *name)
+{
+  FILE *ifp;
+
+  if (name[0] == '-' && name[1] == '\0')
+    return stdin;
+  if ((ifp = fopen(name, "rb")) == NULL)
+    error_exit(errno, NULL);
+  return ifp;
+}
+
+/* Decode files and fold lines of them, one block after another. */
+void
+fold_files(struct linefold_stream *stream, struct iconv_wrap *decoder,
+	   struct output *output, char **files, int nfiles)
+{
+  size_t neof = 0, len, pos, buflen;
   FILE *ifp;
-  char buf[4096], *nbuf;
-  struct linefold_info *lbi;
+  char *buf, *map;
+  int i;
+
+  if ((buf = malloc(INPUT_BLOCKSIZE)) == NULL)
+    error_exit(errno, NULL);
+  for (i = 0; i < nfiles; i++) {
+    ifp = open_input(files[i]);
+
+    if (ifp != stdin && (map = map_input(ifp, &buflen)) != NULL) {
+      /* Mapped file is decoded block by block, not to hold whole of
+	 decoded text.  Incomplete sequence at end of file is dropped. */
+      for (pos = 0; pos < buflen; pos += len) {
+	len = buflen - pos;
+	if (INPUT_BLOCKSIZE < len)
+	  len = INPUT_BLOCKSIZE;
+	if ((len = feed_bytes(stream, decoder, output, map + pos, len,
+			      &neof)) == 0)
+	  break;
+      }
+#if USE_MMAP
+      munmap(map, buflen);
+#endif /* USE_MMAP */
+    } else {
+      /* Incomplete sequence at end of block is carried over to the
+	 next one. */
+      buflen = 0;
+      for (;;) {
+	/* Lines are written out before waiting for more input. */
+	flush_output(output);
+	if ((len = read_block(buf + buflen, INPUT_BLOCKSIZE - buflen,
+			      ifp)) == 0)
+	  break;
+	buflen += len;
+	pos = feed_bytes(stream, decoder, output, buf, buflen, &neof);
+	memmove(buf, buf + pos, buflen - pos);
+	buflen -= pos;
+      }
+    }
+    fclose(ifp);
+    /* Trim EOF at end of file. */
+    end_of_file(output, &neof);
+  }
+  linefold_stream_finish(stream);
+  free(buf);
+}
+
+#if USE_PTHREAD
+
+/*
+ * Decode files and fold lines of them by pipeline.  Returns 0 without
+ * doing anything if threads can't be started.
+ */
+int
+fold_pipelined(struct linefold_stream *stream, struct iconv_wrap *decoder,
+	       struct output *output, char **files, int nfiles)
+{
+  static int keyed = 0;
+  struct pipeline pipeline;
+  pthread_t reader, decoding;
+  int ok = 0;
+
+  if (!keyed) {
+    if (pthread_key_create(&stage_key, NULL) != 0)
+      return 0;
+    keyed = 1;
+  }
+  memset(&pipeline, 0, sizeof(struct pipeline));
+  pipeline.files = files;
+  pipeline.nfiles = nfiles;
+  pipeline.decoder = decoder;
+  pipeline.out = output;
+  if (queue_init(&pipeline.input) != 0)
+    return 0;
+  if (queue_init(&pipeline.decoded) != 0)
+    goto destroy_input;
+  if (queue_init(&pipeline.output) != 0)
+    goto destroy_decoded;
+
+  /* Stages are started from the last, and stopped by end of input
+     passed down from the first.  Errors are passed down as soon as
+     they start. */
+  current_pipeline = &pipeline;
+  current_output = NULL;
+  output->queue = &pipeline.output;
+  if (pthread_create(&pipeline.writer, NULL, &write_stage, &pipeline) != 0)
+    goto restore;
+  if (pthread_create(&decoding, NULL, &decode_stage, &pipeline) != 0) {
+    queue_put_kind(&pipeline.output, BLOCK_END, 0, NULL);
+    goto join_writer;
+  }
+  if (pthread_create(&reader, NULL, &read_stage, &pipeline) != 0) {
+    queue_put_kind(&pipeline.input, BLOCK_END, 0, NULL);
+    queue_get(&pipeline.decoded);
+    queue_release(&pipeline.decoded);
+    queue_put_kind(&pipeline.output, BLOCK_END, 0, NULL);
+    pthread_join(decoding, NULL);
+    goto join_writer;
+  }
+
+  pthread_setspecific(stage_key, &pipeline.output);
+  fold_stage(&pipeline, stream);
+  queue_put_kind(&pipeline.output, BLOCK_END, 0, NULL);
+  pthread_join(reader, NULL);
+  pthread_join(decoding, NULL);
+  pthread_setspecific(stage_key, NULL);
+  ok = 1;
+
+ join_writer:
+  pthread_join(pipeline.writer, NULL);
+ restore:
+  output->queue = NULL;
+  current_output = output;
+  current_pipeline = NULL;
+  queue_destroy(&pipeline.output);
+ destroy_decoded:
+  queue_destroy(&pipeline.decoded);
+ destroy_input:
+  queue_destroy(&pipeline.input);
+  return ok;
+}
+
+/*
+ * Fold lines of decoded blocks, and pass output to writer.  Output is
+ * passed before waiting for more blocks.
+ */
+void
+fold_stage(struct pipeline *pipeline, struct linefold_stream *stream)
+{
+  struct output *output = pipeline->out;
+  struct block *block;
+  size_t neof = 0;
+
+  for (;;) {
+    if ((block = queue_poll(&pipeline->decoded)) == NULL) {
+      flush_output(output);
+      block = queue_get(&pipeline->decoded);
+    }
+    if (block->kind == BLOCK_ERROR)
+      error_exit(block->errnum, block->msg);
+    if (block->kind == BLOCK_END)
+      break;
+    if (block->kind == BLOCK_EOF)
+      end_of_file(output, &neof);
+    else
+      feed_decoded(stream, output, block->bytes, block->len,
+		   block->text, block->textlen, block->intact, &neof);
+    queue_release(&pipeline->decoded);
+  }
+  queue_release(&pipeline->decoded);
+  linefold_stream_finish(stream);
+  flush_output(output);
+}
+
+/*
+ * Read files into blocks.  Mapped file is passed as parts of it, whose
+ * pages are touched here so that they are read in by this thread.
+ */
+void *
+read_stage(void *arg)
+{
+  struct pipeline *pipeline = arg;
+  struct queue *queue = &pipeline->input;
+  struct block *block;
+  FILE *ifp;
+  char *map;
+  const volatile char *page;
+  size_t maplen, pos, len;
+  int i;
+
+  pthread_setspecific(stage_key, queue);
+  for (i = 0; i < pipeline->nfiles; i++) {
+    ifp = open_input(pipeline->files[i]);
+    if (ifp != stdin && (map = map_input(ifp, &maplen)) != NULL) {
+      for (pos = 0; pos < maplen; pos += len) {
+	len = maplen - pos;
+	if (INPUT_BLOCKSIZE < len)
+	  len = INPUT_BLOCKSIZE;
+	for (page = map + pos; page < map + pos + len;
+	     page += PIPELINE_PAGESIZE)
+	  (void)*page;
+	block = queue_reserve(queue);
+	block->kind = BLOCK_DATA;
+	block->data = map + pos;
+	block->len = len;
+	queue_put(queue);
+      }
+    } else {
+      map = NULL;
+      maplen = 0;
+      for (;;) {
+	block = queue_reserve(queue);
+	if ((block->bytes = grow_buffer(block->bytes, &block->size,
+					INPUT_BLOCKSIZE, 1)) == NULL)
+	  error_exit(errno, NULL);
+	if ((len = read_block(block->bytes, INPUT_BLOCKSIZE, ifp)) == 0)
+	  break;
+	block->kind = BLOCK_DATA;
+	block->data = block->bytes;
+	block->len = len;
+	queue_put(queue);
+      }
+    }
+    fclose(ifp);
+    block = queue_reserve(queue);
+    block->kind = BLOCK_EOF;
+    block->map = map;
+    block->maplen = maplen;
+    queue_put(queue);
+  }
+  queue_put_kind(queue, BLOCK_END, 0, NULL);
+  return NULL;
+}
+
+/*
+ * Decode blocks read.  Incomplete sequence at end of a block is carried
+ * over to the next one, and is dropped at end of file.
+ */
+void *
+decode_stage(void *arg)
+{
+  struct pipeline *pipeline = arg;
+  struct queue *queue = &pipeline->decoded;
+  struct block *in, *out;
+  linefold_char *text;
+  char *str, *carry = NULL;
+  size_t len, pos, textlen, carrylen = 0, carrysize = 0;
+
+  pthread_setspecific(stage_key, queue);
+  for (;;) {
+    in = queue_get(&pipeline->input);
+    if (in->kind != BLOCK_DATA) {
+#if USE_MMAP
+      if (in->kind == BLOCK_EOF && in->map != NULL)
+	munmap(in->map, in->maplen);
+#endif /* USE_MMAP */
+      carrylen = 0;
+      queue_put_kind(queue, in->kind, in->errnum, in->msg);
+      if (in->kind != BLOCK_EOF)
+	break;
+      queue_release(&pipeline->input);
+      continue;
+    }
+
+    str = (char *)in->data;
+    len = in->len;
+    if (carrylen > 0) {
+      if ((carry = grow_buffer(carry, &carrysize, carrylen + len, 1))
+	  == NULL)
+	error_exit(errno, NULL);
+      memcpy(carry + carrylen, str, len);
+      str = carry;
+      len += carrylen;
+    }
+    pos = 0;
+    if ((textlen = decode_bytes(pipeline->decoder, str, &pos, len, &text))
+	!= 0) {
+      out = queue_reserve(queue);
+      if ((out->text = grow_buffer(out->text, &out->textsize, textlen,
+				   sizeof(linefold_char))) == NULL)
+	error_exit(errno, NULL);
+      memcpy(out->text, text, sizeof(linefold_char) * textlen);
+      out->textlen = textlen;
+      out->intact = iconv_wrap_intact(pipeline->decoder);
+      /* Bytes are needed only to be written as is. */
+      out->len = 0;
+      if (pipeline->out->verbatim && out->intact) {
+	if ((out->bytes = grow_buffer(out->bytes, &out->size, pos, 1))
+	    == NULL)
+	  error_exit(errno, NULL);
+	memcpy(out->bytes, str, pos);
+	out->len = pos;
+      }
+      out->kind = BLOCK_DATA;
+      queue_put(queue);
+    }
+    /* Error is passed down after text before it. */
+    if (iconv_wrap_failed(pipeline->decoder))
+      decode_bytes(pipeline->decoder, str, &pos, len, &text);
+    if ((carrylen = len - pos) > 0) {
+      if (str != carry &&
+	  (carry = grow_buffer(carry, &carrysize, carrylen, 1)) == NULL)
+	error_exit(errno, NULL);
+      memmove(carry, str + pos, carrylen);
+    }
+    queue_release(&pipeline->input);
+  }
+  free(carry);
+  return NULL;
+}
+
+/* Write out blocks, flushing file before waiting for more. */
+void *
+write_stage(void *arg)
+{
+  struct pipeline *pipeline = arg;
+  struct queue *queue = &pipeline->output;
+  struct block *block;
+
+  for (;;) {
+    if ((block = queue_poll(queue)) == NULL) {
+      fflush(option_output_fp);
+      block = queue_get(queue);
+    }
+    if (block->kind == BLOCK_ERROR)
+      error_exit(block->errnum, block->msg);
+    if (block->kind == BLOCK_END)
+      break;
+    if (fwrite(block->bytes, block->len, 1, option_output_fp) != 1)
+      error_exit(errno, NULL);
+    queue_release(queue);
+  }
+  queue_release(queue);
+  fflush(option_output_fp);
+  return NULL;
+}
+
+/*
+ * Pass error down from the stage calling this, and stop it.  The folder
+ * passes output folded so far before it, and waits for writer to exit.
+ * Returns if called by writer or by other threads.
+ */
+void
+pipeline_fail(struct pipeline *pipeline, int errnum, const char *msg)
+{
+  struct queue *queue = pthread_getspecific(stage_key);
+
+  if (queue == NULL)
+    return;
+  if (queue == &pipeline->output && !pipeline->failed) {
+    pipeline->failed = 1;
+    flush_output(pipeline->out);
+  }
+  queue_put_kind(queue, BLOCK_ERROR, errnum, msg);
+  /* Writer exits the process. */
+  if (queue == &pipeline->output)
+    pthread_join(pipeline->writer, NULL);
+  pthread_exit(NULL);
+}
+
+/* Initialize empty queue.  Returns non-zero on failure. */
+int
+queue_init(struct queue *queue)
+{
+  memset(queue, 0, sizeof(struct queue));
+  if (pthread_mutex_init(&queue->mutex, NULL) != 0)
+    return -1;
+  if (pthread_cond_init(&queue->cond, NULL) != 0) {
+    pthread_mutex_destroy(&queue->mutex);
+    return -1;
+  }
+  return 0;
+}
+
+void
+queue_destroy(struct queue *queue)
+{
+  int i;
+
+  for (i = 0; i < PIPELINE_SLOTS; i++) {
+    free(queue->slots[i].bytes);
+    free(queue->slots[i].text);
+  }
+  pthread_cond_destroy(&queue->cond);
+  pthread_mutex_destroy(&queue->mutex);
+}
+
+/* Wait for a free slot, and return block in it to be filled. */
+struct block *
+queue_reserve(struct queue *queue)
+{
+  struct block *block;
+
+  pthread_mutex_lock(&queue->mutex);
+  while (queue->tail - queue->head == PIPELINE_SLOTS)
+    pthread_cond_wait(&queue->cond, &queue->mutex);
+  block = queue->slots + queue->tail % PIPELINE_SLOTS;
+  pthread_mutex_unlock(&queue->mutex);
+  return block;
+}
+
+/* Put block filled after queue_reserve(). */
+void
+queue_put(struct queue *queue)
+{
+  pthread_mutex_lock(&queue->mutex);
+  queue->tail++;
+  pthread_cond_broadcast(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+/* Put block carrying no data. */
+void
+queue_put_kind(struct queue *queue, int kind, int errnum, const char *msg)
+{
+  struct block *block = queue_reserve(queue);
+
+  block->kind = kind;
+  block->errnum = errnum;
+  block->msg = msg;
+  block->map = NULL;
+  queue_put(queue);
+}
+
+/* Wait for a block, and return it.  It is kept until queue_release(). */
+struct block *
+queue_get(struct queue *queue)
+{
+  struct block *block;
+
+  pthread_mutex_lock(&queue->mutex);
+  while (queue->head == queue->tail)
+    pthread_cond_wait(&queue->cond, &queue->mutex);
+  block = queue->slots + queue->head % PIPELINE_SLOTS;
+  pthread_mutex_unlock(&queue->mutex);
+  return block;
+}
+
+/* Same as queue_get() but returns NULL instead of waiting. */
+struct block *
+queue_poll(struct queue *queue)
+{
+  struct block *block = NULL;
+
+  pthread_mutex_lock(&queue->mutex);
+  if (queue->head != queue->tail)
+    block = queue->slots + queue->head % PIPELINE_SLOTS;
+  pthread_mutex_unlock(&queue->mutex);
+  return block;
+}
+
+/* Free the slot of block got, to be reused by producer. */
+void
+queue_release(struct queue *queue)
+{
+  pthread_mutex_lock(&queue->mutex);
+  queue->head++;
+  pthread_cond_broadcast(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+/*
+ * Grow buffer buf holding *sizep elements of elemsize bytes to hold n
+ * of them.  Returns the buffer, or NULL if memory is exhausted.
+ */
+void *
+grow_buffer(void *buf, size_t *sizep, size_t n, size_t elemsize)
+{
+  size_t size = *sizep? *sizep: OUTPUT_INITSIZE;
+
+  if (buf != NULL && n <= *sizep)
+    return buf;
+  while (size < n)
+    size *= 2;
+  if ((buf = realloc(buf, size * elemsize)) == NULL)
+    return NULL;
+  *sizep = size;
+  return buf;
+}
+
+#endif /* USE_PTHREAD */
+
+int
+main(int argc, char **argv)
+{
+  struct linefold_stream *stream;
+  struct iconv_wrap *decoder, *encoder;
+  struct output output;
   int i;
 
 #if HAVE_LOCALE_H
@@ -292,51 +1264,50 @@ main(int argc, char **argv)
     argv[0] = "-";
     i = 0;
   }
-  text = NULL;
-  textlen = 0;
-  while (i < argc) {
-    if (argv[i][0] == '-' && argv[i][1] == '\0')
-      ifp = stdin;
-    else if ((ifp = fopen(argv[i], "rb")) == NULL)
-      error_exit(errno, NULL);
-    i++;
-
-    nbuf = buf;
-    while (fgets(nbuf, sizeof(buf) - (nbuf - buf) - 1, ifp) != NULL) {
-      size_t bufpos, buflen;
-      bufpos = 0;
-      buflen = strlen(buf);
-      errno = 0;
-      if ((textlen = decode(option_from_code,
-			    buf, &bufpos, buflen,
-			    &text, textlen, option_conversion)) == -1)
-	error_exit(errno,
-		   (errno == EINVAL) ?
-		   "Unsupported character set for input" : NULL);
-
-      nbuf = buf;
-      if (errno == EINVAL)
-	while (bufpos < buflen)
-	  *(nbuf++) = buf[bufpos++];
-    }
-    fclose(ifp);
-    /* Trim EOF at end of file. */
-    if (!option_nostrip_eof)
-      while (textlen > 0 && text[textlen - 1] == (linefold_char) 0x001A)
-	textlen--;
-  }
+  if ((decoder = iconv_wrap_alloc(INTERNAL_LINEFOLD_CHARSET,
+				  option_from_code)) == NULL ||
+      (encoder = iconv_wrap_alloc(option_to_code,
+				  INTERNAL_LINEFOLD_CHARSET)) == NULL)
+    error_exit(errno, NULL);
+  output.encoder = encoder;
+  output.verbatim = iconv_wrap_same(decoder, encoder);
+  output.buf = NULL;
+  output.start = output.len = output.size = 0;
+  if ((output.obuf = malloc(OUTPUT_BUFSIZE)) == NULL)
+    error_exit(errno, NULL);
+  output.olen = 0;
+  output.queue = NULL;
+  current_output = &output;
+  encode_terminator(&output, option_line_terminator,
+		    option_line_terminator_len, &output.line_terminator);
+  encode_terminator(&output, option_paragraph_terminator,
+		    option_paragraph_terminator_len,
+		    &output.paragraph_terminator);
+  encode_terminator(&output, option_text_terminator,
+		    option_text_terminator_len, &output.text_terminator);
+  /* Text is folded as soon as each block is read, or as batches of
+     paragraphs are gathered if threads share work. */
+  linefold_set_jobs(option_jobs);
+  if ((stream = linefold_stream_alloc(NULL, NULL, option_context_code,
+				      option_flags, NULL, &writeout_cb,
+				      option_line_width, &output)) == NULL)
+    error_exit(errno, NULL);
+#if USE_PTHREAD
+  if (!option_pipeline ||
+      !fold_pipelined(stream, decoder, &output, argv + i, argc - i))
+#endif /* USE_PTHREAD */
+    fold_files(stream, decoder, &output, argv + i, argc - i);
 
-  if ((lbi = linefold_alloc(text, textlen, NULL, NULL,
-			    option_context_code, option_flags)) == NULL) {
-    if (errno)
-      error_exit(errno, NULL);
-    if (text != NULL)
-      free(text);
-    exit(0);
-  }
-  linefold(lbi, text, NULL, &writeout_cb, option_line_width, NULL);
-  linefold_free(lbi);
-  free(text);
+  linefold_stream_free(stream);
+  flush_output(&output);
+  current_output = NULL;
+  iconv_wrap_free(decoder);
+  iconv_wrap_free(encoder);
+  free(output.buf);
+  free(output.obuf);
+  free(output.line_terminator.str);
+  free(output.paragraph_terminator.str);
+  free(output.text_terminator.str);
   fclose(option_output_fp);
 
   exit(0);
@@ -47,6 +47,7 @@ int option_conversion=0;
 char *option_conversion_str=NULL;
 char *option_from_code=NULL;
 int option_help=0;
+int option_jobs=1;
 /* linefold_char *option_line_starter=NULL;
    size_t option_line_starter_len=0; */
 linefold_char *option_line_terminator=NULL;
@@ -58,6 +59,7 @@ char *option_output=NULL;
 linefold_char *option_paragraph_terminator=NULL;
 size_t option_paragraph_terminator_len=0;
 int option_nostrip_eof = 0;
+int option_pipeline = 0;
 /* linefold_char *option_text_starter=NULL;
    size_t option_text_starter_len=0; */
 linefold_char *option_text_terminator=NULL;
@@ -197,6 +199,14 @@ struct option_table options[] = {
     "MARK are AL (alphabetic letters), not OP (opening punctuation)\n"
     "[cf. UAX#14]."
   }, 
+  {
+    'j', "jobs", "number",
+    0, 0,0,&option_jobs,0,0,0,
+    "Number of threads to break lines.  With more than one, lines\n"
+    "are written out by batches of paragraphs, so that output of\n"
+    "live pipes is delayed.  0 is the number of online processors.\n"
+    "Default is 1."
+  },
   /* {
     '-', "line starter", "string",
     0, 0,0,0,0,&option_line_starter,&option_line_starter_len,
@@ -260,6 +270,12 @@ struct option_table options[] = {
     "Newline sequnece to replace end of paragraph.  Default is no\n"
     "replacement."
   },
+  {
+    '-', "pipeline", "yes|no",
+    0, 0,&option_pipeline,0,0,0,0,
+    "Read, decode, fold and write out on separate threads connected\n"
+    "by bounded queues, so that reading and writing overlap folding."
+  },
   {
     '-', "relax kana non-starter", "yes|no",
     0, LINEFOLD_OPTION_RELAX_KANA_NS,0,0,0,0,0,
@@ -0,0 +1,63 @@
+#! /bin/sh
+#
+# Benchmark of decoding by iconv: time to fold 1, 2, 4 and 8 copies of
+# mixed CJK/Latin text in EUC-JP should grow linearly.
+#
+# Usage: tests/bench-decode.sh [linefold [width]]
+#
+# Width defaults to 4000, so that lines are at the hard limit and long
+# runs are decoded at once.  Needs iconv(1) and GNU date(1).
+#
+# $Id$
+
+LINEFOLD=${1:-./linefold}
+WIDTH=${2:-4000}
+TMP=${TMPDIR:-/tmp}/bench-decode.$$
+
+trap 'rm -rf "$TMP"' 0 1 2 15
+mkdir "$TMP" || exit 1
+
+# About 1.7 MB of UTF-8: paragraphs of Latin words and kana/kanji.
+awk 'BEGIN {
+  latin = "The quick brown fox jumps over the lazy dog. ";
+  cjk = "\343\201\223\343\202\214\343\201\257\346\227\245\346\234\254" \
+        "\350\252\236\343\201\256\346\226\207\347\253\240\343\201\247" \
+        "\343\201\231\343\200\202";
+  for (p = 0; p < 2000; p++) {
+    line = "";
+    for (i = 0; i < 12; i++)
+      line = line latin cjk;
+    print line;
+    print "";
+  }
+}' > "$TMP/utf8" || exit 1
+iconv -f UTF-8 -t EUC-JP < "$TMP/utf8" > "$TMP/x1" || exit 1
+for n in 2 4 8; do
+  h=`expr $n / 2`
+  cat "$TMP/x$h" "$TMP/x$h" > "$TMP/x$n"
+done
+
+base=
+status=0
+printf '%6s %12s %10s %12s\n' copies bytes seconds 'ns/byte'
+for n in 1 2 4 8; do
+  bytes=`wc -c < "$TMP/x$n"`
+  start=`date +%s%N`
+  "$LINEFOLD" -f EUC-JP -t UTF-8 -w "$WIDTH" < "$TMP/x$n" > /dev/null ||
+    exit 1
+  end=`date +%s%N`
+  awk -v n=$n -v bytes=$bytes -v ns=`expr $end - $start` 'BEGIN {
+    printf "%6d %12d %10.3f %12.2f\n", n, bytes, ns / 1e9, ns / bytes
+  }'
+  perbyte=`expr \( $end - $start \) / $bytes`
+  if test -z "$base"; then
+    base=$perbyte
+  elif test $perbyte -gt `expr $base \* 2 + 1`; then
+    # Time per byte more than doubled: not linear.
+    status=1
+  fi
+done
+if test $status -ne 0; then
+  echo "Time per byte grows with size."
+fi
+exit $status
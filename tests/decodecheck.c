@@ -0,0 +1,178 @@
+/*
+ * Differential test of kernels decoding UTF-8 runs.
+ *
+ * Copyright (C) 2006 by Hatuka*nezumi - IKEDA Soji.  All rights reserved.
+ *
+ * This file is part of the Linefold Package.  This program is free
+ * software; you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.  This program is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the COPYING file for more details.
+ *
+ * $Id$
+ */
+
+/*
+ * Runs decoded by the best kernel are compared with sequences decoded
+ * byte by byte, over text mixing sequences of every length with illegal
+ * ones.  Kernels may stop early but mustn't decode illegal sequences.
+ */
+
+#include <stdio.h>
+#include "common.h"
+#include "linefold.h"
+
+#define TEXTLEN 4096
+
+extern int decode_ascii_kernel(void);
+extern size_t decode_utf8_run(int, const unsigned char *, size_t,
+			      linefold_char *, size_t *);
+
+/* Sequences mixed into text; the last ones are illegal. */
+static const char *pieces[] = {
+  "a", " ", "~", "The quick brown fox jumps over ", "\302\240",
+  "\303\251", "\337\277", "\340\240\200", "\343\201\202",
+  "\344\270\200", "\355\237\277", "\356\200\200", "\357\277\275",
+  "\360\237\230\200", "\364\217\277\277",
+  /* illegal */
+  "\200", "\277", "\300\200", "\301\277", "\340\200\200", "\340\237\277",
+  "\355\240\200", "\355\277\277", "\365\200\200\200", "\377", "\343\201",
+  "\302"
+};
+#define NLEGAL 15
+
+static unsigned long seed = 1;
+
+static unsigned long
+next_random(void)
+{
+  seed = seed * 1103515245UL + 12345UL;
+  return (seed >> 16) & 0x7FFF;
+}
+
+/* Make text of len bytes, one in rate pieces being illegal. */
+static void
+make_text(unsigned char *text, size_t len, unsigned long rate)
+{
+  const char *p;
+  size_t i = 0, n, k;
+
+  while (i < len) {
+    if (next_random() % rate == 0)
+      k = NLEGAL + next_random() % (sizeof(pieces) / sizeof(pieces[0]) -
+				    NLEGAL);
+    else
+      k = next_random() % NLEGAL;
+    p = pieces[k];
+    for (n = 0; p[n] && i < len; n++)
+      text[i++] = (unsigned char)p[n];
+  }
+}
+
+/* Decode a sequence of up to three bytes.  Returns its length, or 0 if
+   it is illegal, of four bytes or incomplete. */
+static size_t
+decode_one(const unsigned char *p, size_t len, unsigned long *cp)
+{
+  unsigned long c = p[0];
+
+  if (c < 0x80) {
+    *cp = c;
+    return 1;
+  }
+  if (c < 0xC2 || 0xF0 <= c)
+    return 0;
+  if (c < 0xE0) {
+    if (len < 2 || (p[1] & 0xC0) != 0x80)
+      return 0;
+    *cp = ((c & 0x1F) << 6) | (p[1] & 0x3F);
+    return 2;
+  }
+  if (len < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80)
+    return 0;
+  c = ((c & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+  if (c < 0x800 || (0xD800 <= c && c < 0xE000))
+    return 0;
+  *cp = c;
+  return 3;
+}
+
+static int
+check_run(int kernel, const unsigned char *text, size_t len, int legal,
+	  const char *what)
+{
+  linefold_char ostr[TEXTLEN];
+  unsigned long c;
+  size_t n, olen, i, o, k;
+
+  n = decode_utf8_run(kernel, text, len, ostr, &olen);
+  for (i = 0, o = 0; i < n; i += k, o++) {
+    if ((k = decode_one(text + i, n - i, &c)) == 0) {
+      fprintf(stderr, "%s: illegal sequence at %lu decoded\n", what,
+	      (unsigned long)i);
+      return 0;
+    }
+    if (olen <= o || (unsigned long)ostr[o] != c) {
+      fprintf(stderr, "%s: U+%04lX at %lu decoded as U+%04lX\n", what, c,
+	      (unsigned long)i, (olen <= o)? 0UL: (unsigned long)ostr[o]);
+      return 0;
+    }
+  }
+  if (i != n || o != olen) {
+    fprintf(stderr, "%s: %lu bytes to %lu characters, expected %lu\n",
+	    what, (unsigned long)n, (unsigned long)olen, (unsigned long)o);
+    return 0;
+  }
+  /* Text of legal sequences up to three bytes is decoded but the end. */
+  if (legal && n + 16 <= len) {
+    fprintf(stderr, "%s: stopped at %lu of %lu bytes\n", what,
+	    (unsigned long)n, (unsigned long)len);
+    return 0;
+  }
+  return 1;
+}
+
+int
+main(void)
+{
+  static const unsigned long rates[] = { 2, 7, 50, 1000 };
+  unsigned char text[TEXTLEN];
+  char what[80];
+  size_t r, start, k;
+  int kernel, failed = 0;
+
+  if ((kernel = decode_ascii_kernel()) < 2) {
+    printf("no kernel decodes UTF-8\n");
+    return 77;
+  }
+
+  for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+    sprintf(what, "rate %lu", rates[r]);
+    make_text(text, TEXTLEN, rates[r]);
+    for (start = 0; start < TEXTLEN; start++)
+      if (!check_run(kernel, text + start, TEXTLEN - start, 0, what))
+	failed++;
+  }
+
+  /* Legal sequences only, without those of four bytes. */
+  for (start = 0; start < TEXTLEN; start += k) {
+    k = next_random() % 13;
+    if (TEXTLEN < start + strlen(pieces[k]))
+      break;
+    memcpy(text + start, pieces[k], strlen(pieces[k]));
+    k = strlen(pieces[k]);
+  }
+  for (k = 0; k < 64; k++)
+    if (!check_run(kernel, text, start - k * 61, 1, "legal"))
+      failed++;
+
+  if (failed) {
+    printf("%d checks failed\n", failed);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,205 @@
+/*
+ * Differential test of kernels classifying ASCII runs.
+ *
+ * Copyright (C) 2006 by Hatuka*nezumi - IKEDA Soji.  All rights reserved.
+ *
+ * This file is part of the Linefold Package.  This program is free
+ * software; you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.  This program is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the COPYING file for more details.
+ *
+ * $Id$
+ */
+
+/*
+ * Every kernel the CPU supports, and linefold_alloc_ex() using the best
+ * of them, are compared with properties got character by character.
+ */
+
+#include <stdio.h>
+#include "common.h"
+#include "linefold.h"
+#include "linefoldint.h"
+
+#define TEXTLEN 4096
+
+static const char *contexts[] = {
+  NULL, "UTF-8", "EUC-JP", "GB2312", "BIG5", "EUC-KR"
+};
+
+static const linefold_flags flagsets[] = {
+  LINEFOLD_OPTION_DEFAULT,
+  LINEFOLD_OPTION_GENERIC_WIDTH,
+  LINEFOLD_OPTION_NARROW_LATIN | LINEFOLD_OPTION_NARROW_GREEK |
+  LINEFOLD_OPTION_NARROW_CYRILLIC,
+  LINEFOLD_OPTION_BREAK_HY | LINEFOLD_OPTION_BREAK_SOFT_HYPHEN |
+  LINEFOLD_OPTION_NOBREAK_NL | LINEFOLD_OPTION_NOBREAK_VT |
+  LINEFOLD_OPTION_NOBREAK_FF,
+  LINEFOLD_OPTION_OPAL_IS_AL | LINEFOLD_OPTION_NSEX_IS_EX |
+  LINEFOLD_OPTION_IDSP_IS_SP | LINEFOLD_OPTION_BREAK_SPCM
+};
+
+/* Non-ASCII characters mixed into text. */
+static const unsigned long others[] = {
+  0x80, 0xA0, 0xAD, 0xE9, 0x3B1, 0x430, 0x2014, 0x3000, 0x3042, 0x4E00,
+  0xAC00, 0xFF01, 0x1F600, 0x20000
+};
+
+static unsigned long seed = 1;
+
+static unsigned long
+next_random(void)
+{
+  seed = seed * 1103515245UL + 12345UL;
+  return (seed >> 16) & 0x7FFF;
+}
+
+/* Make text of ASCII runs of various lengths, one in rate characters
+   being non-ASCII. */
+static void
+make_text(linefold_char *text, size_t len, unsigned long rate)
+{
+  size_t i;
+
+  for (i=0; i < len; i++)
+    if (next_random() % rate == 0)
+      text[i] = (linefold_char)
+	others[next_random() % (sizeof(others) / sizeof(others[0]))];
+    else
+      text[i] = (linefold_char)(next_random() % ASCII_TABSIZE);
+}
+
+/* Get properties character by character. */
+static void
+reference_props(linefold_lbprop_funcptr lbprop_func,
+		const linefold_char *text, size_t len,
+		linefold_width *widths, linefold_class *lbclasses,
+		linefold_flags flags)
+{
+  size_t i;
+
+  for (i=0; i < len; i++) {
+    (*lbprop_func)(text[i], widths+i, lbclasses+i);
+    linefold_tailor_lbprop(text[i], widths+i, lbclasses+i, flags);
+  }
+}
+
+static int
+check_kernel(int kernel, const linefold_char *text, size_t len,
+	     const linefold_width *ascii_widths,
+	     const linefold_class *ascii_classes,
+	     const linefold_width *ref_widths,
+	     const linefold_class *ref_classes, const char *what)
+{
+  linefold_width widths[TEXTLEN];
+  linefold_class lbclasses[TEXTLEN];
+  size_t n, run, i;
+
+  for (run=0; run < len && (unsigned long)text[run] < ASCII_TABSIZE; run++)
+    ;
+  n = linefold_ascii_props_kernel(kernel, text, len,
+				  ascii_widths, ascii_classes,
+				  widths, lbclasses);
+  if (n != run) {
+    fprintf(stderr, "%s: kernel %d: %lu characters, expected %lu\n",
+	    what, kernel, (unsigned long)n, (unsigned long)run);
+    return 0;
+  }
+  for (i=0; i < n; i++)
+    if (widths[i] != ref_widths[i] || lbclasses[i] != ref_classes[i]) {
+      fprintf(stderr, "%s: kernel %d: U+%04lX: width %d class %d, "
+	      "expected %d %d\n", what, kernel, (unsigned long)text[i],
+	      (int)widths[i], (int)lbclasses[i],
+	      (int)ref_widths[i], (int)ref_classes[i]);
+      return 0;
+    }
+  return 1;
+}
+
+static int
+check_alloc(const linefold_char *text, size_t len, const char *chset,
+	    linefold_flags flags, const linefold_width *ref_widths,
+	    const linefold_class *ref_classes, const char *what)
+{
+  struct linefold_info *lbinfo;
+  size_t i;
+  int ok = 1;
+
+  if ((lbinfo = linefold_alloc_ex(text, len, NULL, NULL, chset, flags,
+				  LINEFOLD_INFO_DEFAULT)) == NULL) {
+    fprintf(stderr, "%s: linefold_alloc_ex() failed\n", what);
+    return 0;
+  }
+  for (i=0; i < len; i++)
+    if (lbinfo->widths[i] != ref_widths[i] ||
+	lbinfo->lbclasses[i] != ref_classes[i]) {
+      fprintf(stderr, "%s: linefold_alloc_ex(): U+%04lX at %lu: "
+	      "width %d class %d, expected %d %d\n", what,
+	      (unsigned long)text[i], (unsigned long)i,
+	      (int)lbinfo->widths[i], (int)lbinfo->lbclasses[i],
+	      (int)ref_widths[i], (int)ref_classes[i]);
+      ok = 0;
+      break;
+    }
+  linefold_free(lbinfo);
+  return ok;
+}
+
+int
+main(void)
+{
+  static const unsigned long rates[] = { 3, 17, 64, 1000, TEXTLEN * 8 };
+  linefold_char text[TEXTLEN];
+  linefold_width ref_widths[TEXTLEN], ascii_widths[ASCII_TABSIZE];
+  linefold_class ref_classes[TEXTLEN], ascii_classes[ASCII_TABSIZE];
+  linefold_char c;
+  linefold_lbprop_funcptr lbprop_func;
+  char what[80];
+  size_t i, r, f, start;
+  int kernel, best, failed = 0;
+
+  best = linefold_ascii_kernel();
+  printf("kernels 0 to %d\n", best);
+
+  for (i=0; i < sizeof(contexts) / sizeof(contexts[0]); i++)
+    for (f=0; f < sizeof(flagsets) / sizeof(flagsets[0]); f++) {
+      lbprop_func = linefold_find_lbprop_func(contexts[i], flagsets[f]);
+      for (c=0; c < ASCII_TABSIZE; c++)
+	reference_props(lbprop_func, &c, 1, ascii_widths + c,
+			ascii_classes + c, flagsets[f]);
+
+      for (r=0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+	sprintf(what, "context %s, flags 0x%lX, rate %lu",
+		contexts[i]? contexts[i]: "(none)",
+		(unsigned long)flagsets[f], rates[r]);
+	make_text(text, TEXTLEN, rates[r]);
+	reference_props(lbprop_func, text, TEXTLEN, ref_widths, ref_classes,
+			flagsets[f]);
+
+	/* Starting at every alignment, and at every non-ASCII character. */
+	for (start=0; start < TEXTLEN; start++) {
+	  if (32 <= start && (unsigned long)text[start-1] < ASCII_TABSIZE)
+	    continue;
+	  for (kernel=0; kernel <= best; kernel++)
+	    if (!check_kernel(kernel, text + start, TEXTLEN - start,
+			      ascii_widths, ascii_classes,
+			      ref_widths + start, ref_classes + start, what))
+	      failed++;
+	}
+	if (!check_alloc(text, TEXTLEN, contexts[i], flagsets[f],
+			 ref_widths, ref_classes, what))
+	  failed++;
+      }
+    }
+
+  if (failed) {
+    printf("%d checks failed\n", failed);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}